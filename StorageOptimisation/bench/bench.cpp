@@ -0,0 +1,245 @@
+// Benchmark of the C++ engines on seeded instances, outside of R.
+//
+//   g++ -O2 -std=gnu++17 -pthread -I../src bench.cpp -o bench
+//   ./bench [--families uniform,triplets] [--sizes 1000,100000] [--seeds 3]
+//           [--engines ffd,bfd,exact] [--time-limit 1] [--threads 1]
+//           [--format csv|json]
+//
+// Every (family, n, seed, engine) case runs in a child process, so that the
+// peak memory reported (ru_maxrss, instance included) is the case's own.
+// One line per case is written to stdout, as CSV with a header or as JSON
+// lines, for regression tracking; the wall time only covers the engine.
+// Unless --sizes is given, every family is swept from 10^2 to 10^7 items,
+// each engine up to the size it handles in reasonable time (see max_items).
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <chrono>
+#include <sstream>
+#include <stdexcept>
+
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#include "packingState.h"
+#include "greedyPacking.h"
+#include "lowerBounds.h"
+#include "indexSort.h"
+#include "localSearch.h"
+#include "exactSolver.h"
+#include "branchAndBound.h"
+#include "portfolio.h"
+#include "onlinePacker.h"
+#include "searchBudget.h"
+#include "generators.h"
+
+static const std::vector<std::string> ENGINES = {
+  "ffd", "bfd", "online", "local_search", "bb", "exact", "portfolio"
+};
+
+struct Options {
+  std::vector<std::string> families = instance_families();
+  std::vector<int> sizes = {100, 1000, 10000, 100000, 1000000, 10000000};
+  int seeds = 3;
+  std::vector<std::string> engines = ENGINES;
+  double time_limit = 1;
+  int threads = 1;
+  bool json = false;
+  bool sweep = true; // sizes not given: each engine stops at max_items
+};
+
+struct Result {
+  double seconds;
+  long long nodes;
+  int bins;
+  int lower_bound;
+  int optimal; // 1 when the engine proved its packing optimal
+  int capacity;
+  long peak_kb;
+};
+
+// Largest instance an engine is run on in a sweep
+static int max_items(const std::string& engine) {
+  if (engine == "local_search") return 100000;
+  if (engine == "bb" || engine == "exact" || engine == "portfolio") return 10000;
+  return 10000000;
+}
+
+static std::vector<std::string> split(const std::string& list) {
+  std::vector<std::string> out;
+  std::stringstream stream(list);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    if (!item.empty()) out.push_back(item);
+  }
+  return out;
+}
+
+static Options parse_options(int argc, char** argv) {
+  Options options;
+  for (int a = 1; a < argc; a++) {
+    std::string flag = argv[a];
+    if (a + 1 >= argc) throw std::invalid_argument("missing value after " + flag);
+    std::string value = argv[++a];
+    if (flag == "--families") options.families = split(value);
+    else if (flag == "--sizes") {
+      options.sizes.clear();
+      options.sweep = false;
+      for (const std::string& s : split(value)) options.sizes.push_back(std::atoi(s.c_str()));
+    }
+    else if (flag == "--seeds") options.seeds = std::atoi(value.c_str());
+    else if (flag == "--engines") options.engines = split(value);
+    else if (flag == "--time-limit") options.time_limit = std::atof(value.c_str());
+    else if (flag == "--threads") options.threads = std::atoi(value.c_str());
+    else if (flag == "--format") options.json = value == "json";
+    else throw std::invalid_argument("unknown option " + flag);
+  }
+  for (const std::string& engine : options.engines) {
+    if (std::find(ENGINES.begin(), ENGINES.end(), engine) == ENGINES.end()) {
+      throw std::invalid_argument("unknown engine '" + engine + "'");
+    }
+  }
+  for (const std::string& family : options.families) make_instance(family, 0, 1);
+  return options;
+}
+
+static int count_bins(const std::vector<int>& assignment) {
+  int bins = 0;
+  for (int b : assignment) bins = std::max(bins, b + 1);
+  return bins;
+}
+
+// Runs one engine on the instance; nodes and optimal are 0 for the heuristics
+static Result run_engine(const std::string& engine, const Instance& instance, const Options& options) {
+  const std::vector<int>& items = instance.sizes;
+  int n = items.size();
+  int capacity = instance.capacity;
+  Result result = Result();
+  result.capacity = capacity;
+  SearchBudget budget(options.time_limit);
+  auto start = std::chrono::steady_clock::now();
+
+  if (engine == "ffd" || engine == "bfd" || engine == "local_search") {
+    IndexSorter sorter;
+    std::vector<int> order, sorted(n);
+    sorter.sort(items.data(), n, order);
+    for (int k = 0; k < n; k++) sorted[k] = items[order[k]];
+    PackingState state(capacity, n);
+    if (engine == "bfd") pack_best_fit(sorted.data(), n, state);
+    else pack_first_fit(sorted.data(), n, state);
+    result.bins = state.num_bins();
+    if (engine == "local_search") {
+      std::vector<int> assignment(n);
+      for (int k = 0; k < n; k++) assignment[order[k]] = state.assignment[k];
+      LocalSearch search(items.data(), n, capacity, assignment.data(), 1);
+      result.bins = search.improve(lower_bound_l2(sorted, capacity), budget);
+      result.nodes = search.nodes();
+    }
+  } else if (engine == "online") {
+    OnlinePacker packer(capacity, OnlinePacker::BEST_FIT);
+    for (int s : items) packer.add(s);
+    result.bins = packer.num_bins();
+  } else if (engine == "bb") {
+    BranchAndBoundSolver solver(items, capacity);
+    solver.solve(budget);
+    result.bins = solver.num_bins();
+    result.nodes = solver.nodes();
+    result.optimal = solver.optimal();
+  } else if (engine == "exact") {
+    ExactSolver solver(items, capacity);
+    result.bins = count_bins(solver.solve(options.threads, budget));
+    result.nodes = solver.nodes();
+    result.optimal = solver.optimal();
+  } else if (engine == "portfolio") {
+    Portfolio portfolio(items.data(), items.size(), capacity);
+    portfolio.solve(options.threads + 1, budget, 1);
+    result.bins = portfolio.num_bins();
+    result.optimal = portfolio.optimal();
+  }
+  result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::vector<int> sorted(items);
+  std::sort(sorted.begin(), sorted.end(), std::greater<int>());
+  result.lower_bound = lower_bound_l2(sorted, capacity);
+  return result;
+}
+
+// Runs the case in a child process and reads its result back through a pipe
+static bool run_case(const std::string& engine, const std::string& family, int n, int seed,
+                     const Options& options, Result& result) {
+  int channel[2];
+  if (pipe(channel) != 0) return false;
+  pid_t child = fork();
+  if (child < 0) return false;
+  if (child == 0) {
+    close(channel[0]);
+    Instance instance = make_instance(family, n, seed);
+    Result r = run_engine(engine, instance, options);
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    r.peak_kb = usage.ru_maxrss;
+    ssize_t written = write(channel[1], &r, sizeof r);
+    _exit(written == (ssize_t) sizeof r ? 0 : 1);
+  }
+  close(channel[1]);
+  ssize_t got = read(channel[0], &result, sizeof result);
+  close(channel[0]);
+  int status = 0;
+  waitpid(child, &status, 0);
+  return got == (ssize_t) sizeof result && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+static void print_result(const Options& options, const std::string& family, int n, int seed,
+                         const std::string& engine, const Result& r) {
+  if (options.json) {
+    std::printf("{\"family\":\"%s\",\"n\":%d,\"seed\":%d,\"capacity\":%d,\"engine\":\"%s\","
+                "\"threads\":%d,\"seconds\":%.6f,\"nodes\":%lld,\"bins\":%d,\"lower_bound\":%d,"
+                "\"gap\":%d,\"optimal\":%s,\"peak_kb\":%ld}\n",
+                family.c_str(), n, seed, r.capacity, engine.c_str(), options.threads, r.seconds,
+                r.nodes, r.bins, r.lower_bound, r.bins - r.lower_bound,
+                r.optimal ? "true" : "false", r.peak_kb);
+  } else {
+    std::printf("%s,%d,%d,%d,%s,%d,%.6f,%lld,%d,%d,%d,%d,%ld\n", family.c_str(), n, seed,
+                r.capacity, engine.c_str(), options.threads, r.seconds, r.nodes, r.bins,
+                r.lower_bound, r.bins - r.lower_bound, r.optimal, r.peak_kb);
+  }
+  std::fflush(stdout);
+}
+
+int main(int argc, char** argv) {
+  Options options;
+  try {
+    options = parse_options(argc, argv);
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "bench: %s\n", e.what());
+    return 2;
+  }
+
+  if (!options.json) {
+    std::printf("family,n,seed,capacity,engine,threads,seconds,nodes,bins,lower_bound,gap,optimal,peak_kb\n");
+  }
+  int failures = 0;
+  for (const std::string& family : options.families) {
+    for (int n : options.sizes) {
+      for (int seed = 1; seed <= options.seeds; seed++) {
+        for (const std::string& engine : options.engines) {
+          if (options.sweep && n > max_items(engine)) continue;
+          Result result;
+          if (run_case(engine, family, n, seed, options, result)) {
+            print_result(options, family, n, seed, engine, result);
+          } else {
+            std::fprintf(stderr, "bench: %s on %s n=%d seed=%d failed\n",
+                         engine.c_str(), family.c_str(), n, seed);
+            failures++;
+          }
+        }
+      }
+    }
+  }
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,109 @@
+#ifndef BENCH_GENERATORS_H
+#define BENCH_GENERATORS_H
+
+#include <vector>
+#include <string>
+#include <random>
+#include <algorithm>
+#include <stdexcept>
+
+// Seeded instance generators for the benchmark. The same (family, n, seed)
+// always gives the same instance, on every platform: only std::mt19937_64
+// is used, drawing integers by rejection instead of the implementation
+// defined std::uniform_int_distribution.
+struct Instance {
+  std::vector<int> sizes;
+  int capacity;
+};
+
+class InstanceRng {
+public:
+  explicit InstanceRng(unsigned long long seed) : engine(seed) {}
+
+  // Uniform integer in [lo, hi]
+  int uniform(int lo, int hi) {
+    unsigned long long range = (unsigned long long) (hi - lo) + 1;
+    unsigned long long limit = engine.max() - engine.max() % range;
+    unsigned long long x;
+    do x = engine(); while (x >= limit);
+    return lo + (int) (x % range);
+  }
+
+  template <typename T>
+  void shuffle(std::vector<T>& v) {
+    for (int i = (int) v.size() - 1; i > 0; i--) std::swap(v[i], v[uniform(0, i)]);
+  }
+
+private:
+  std::mt19937_64 engine;
+};
+
+// Sizes uniform in [1, capacity / 2], capacity 10000
+inline Instance uniform_instance(int n, InstanceRng& rng) {
+  Instance instance{std::vector<int>(n), 10000};
+  for (int& s : instance.sizes) s = rng.uniform(1, instance.capacity / 2);
+  return instance;
+}
+
+// Falkenauer's uniform class: sizes in [20, 100], capacity 150
+inline Instance falkenauer_instance(int n, InstanceRng& rng) {
+  Instance instance{std::vector<int>(n), 150};
+  for (int& s : instance.sizes) s = rng.uniform(20, 100);
+  return instance;
+}
+
+// Falkenauer's triplets: capacity 1000, every bin of the optimal packing
+// holds exactly three items (one in [380, 490], two in [250, 500)), so the
+// optimum is n / 3. Hard for FFD and for the lower bounds alike.
+inline Instance triplet_instance(int n, InstanceRng& rng) {
+  Instance instance{std::vector<int>(), 1000};
+  for (int bin = 0; bin < n / 3; bin++) {
+    int first = rng.uniform(380, 490);
+    int second = rng.uniform(250, (instance.capacity - first) / 2);
+    instance.sizes.push_back(first);
+    instance.sizes.push_back(second);
+    instance.sizes.push_back(instance.capacity - first - second);
+  }
+  rng.shuffle(instance.sizes);
+  return instance;
+}
+
+// Scholl, Klein and Jürgens' first data set: capacity in {100, 120, 150} and
+// sizes in [1, 100], [20, 100] or [30, 100], chosen from the seed
+inline Instance scholl_instance(int n, InstanceRng& rng) {
+  static const int capacities[3] = {100, 120, 150};
+  static const int smallest[3] = {1, 20, 30};
+  Instance instance{std::vector<int>(n), capacities[rng.uniform(0, 2)]};
+  int lo = smallest[rng.uniform(0, 2)];
+  for (int& s : instance.sizes) s = rng.uniform(lo, 100);
+  return instance;
+}
+
+// Few distinct sizes, as when many copies of the same games are stored:
+// 16 sizes in [1, capacity / 2], capacity 10000, each item picks one
+inline Instance duplicate_instance(int n, InstanceRng& rng) {
+  Instance instance{std::vector<int>(n), 10000};
+  std::vector<int> sizes(16);
+  for (int& s : sizes) s = rng.uniform(1, instance.capacity / 2);
+  for (int& s : instance.sizes) s = sizes[rng.uniform(0, 15)];
+  return instance;
+}
+
+inline const std::vector<std::string>& instance_families() {
+  static const std::vector<std::string> families = {
+    "uniform", "falkenauer", "triplets", "scholl", "duplicates"
+  };
+  return families;
+}
+
+inline Instance make_instance(const std::string& family, int n, unsigned long long seed) {
+  InstanceRng rng(seed);
+  if (family == "uniform") return uniform_instance(n, rng);
+  if (family == "falkenauer") return falkenauer_instance(n, rng);
+  if (family == "triplets") return triplet_instance(n, rng);
+  if (family == "scholl") return scholl_instance(n, rng);
+  if (family == "duplicates") return duplicate_instance(n, rng);
+  throw std::invalid_argument("unknown instance family '" + family + "'");
+}
+
+#endif
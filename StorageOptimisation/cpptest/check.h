@@ -0,0 +1,40 @@
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+// Minimal assertions for the C++ tests of the engines: a failed CHECK is
+// reported with its line and the case being run, and the program exits with
+// the number of failures (see the Makefile).
+
+static int check_failures = 0;
+static std::string check_case;
+
+#define CHECK(condition)                                                        \
+  do {                                                                          \
+    if (!(condition)) {                                                         \
+      if (++check_failures <= 20) {                                             \
+        std::printf("%s:%d: CHECK(%s) failed [%s]\n", __FILE__, __LINE__,       \
+                    #condition, check_case.c_str());                            \
+      }                                                                         \
+    }                                                                           \
+  } while (0)
+
+inline int check_report(const char* name) {
+  std::printf("%s: %s (%d failure%s)\n", name, check_failures ? "FAILED" : "ok", check_failures,
+              check_failures == 1 ? "" : "s");
+  return check_failures ? 1 : 0;
+}
+
+// n sizes drawn uniformly in [low, high]
+inline std::vector<int> random_sizes(std::mt19937& rng, int n, int low, int high) {
+  std::uniform_int_distribution<int> size(low, high);
+  std::vector<int> sizes(n);
+  for (int& s : sizes) s = size(rng);
+  return sizes;
+}
+
+#endif
@@ -0,0 +1,68 @@
+// Branch and bound of solve_bin_packing: it beats its first-fit decreasing
+// incumbent when FFD is not optimal, and finds the optimum of ExactSolver on
+// random instances, with feasible packings whose loads are the ones returned.
+
+#include <string>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <functional>
+
+#include "branchAndBound.h"
+#include "exactSolver.h"
+#include "check.h"
+
+static int ffd_bins(std::vector<int> items, int capacity) {
+  std::sort(items.begin(), items.end(), std::greater<int>());
+  PackingState state(capacity, items.size());
+  pack_first_fit(items.data(), items.size(), state);
+  return state.num_bins();
+}
+
+// Runs the solver to the end and checks its packing; returns its bins
+static int check_solver(const std::vector<int>& items, int capacity) {
+  BranchAndBoundSolver solver(items, capacity);
+  std::vector<int> loads = solver.solve();
+  CHECK(solver.optimal());
+  CHECK((int) loads.size() == solver.num_bins());
+
+  std::vector<int> load(solver.num_bins(), 0);
+  const std::vector<int>& bin = solver.assignment();
+  for (int k = 0; k < (int) items.size(); k++) {
+    CHECK(bin[k] >= 0 && bin[k] < solver.num_bins());
+    if (bin[k] >= 0 && bin[k] < solver.num_bins()) load[bin[k]] += items[solver.sorted_items()[k]];
+  }
+  CHECK(load == loads);
+  for (int l : load) CHECK(l <= capacity);
+  return solver.num_bins();
+}
+
+int main() {
+  // FFD: {6, 3}, {5, 2, 2}, {2}; optimal: {6, 2, 2}, {5, 3, 2}
+  check_case = "ffd suboptimal";
+  std::vector<int> items = {2, 6, 2, 3, 5, 2};
+  CHECK(ffd_bins(items, 10) == 3);
+  CHECK(check_solver(items, 10) == 2);
+
+  std::mt19937 rng(9);
+  int improved = 0;
+  for (int t = 0; t < 3000; t++) {
+    int capacity = t % 3 == 0 ? 10 : t % 3 == 1 ? 100 : 1000;
+    int n = 1 + rng() % 14;
+    std::vector<int> sizes = random_sizes(rng, n, 1, capacity * 2 / 3);
+    check_case = "capacity " + std::to_string(capacity) + ", case " + std::to_string(t);
+    int bins = check_solver(sizes, capacity);
+
+    ExactSolver exact(sizes, capacity);
+    SearchBudget budget;
+    std::vector<int> assignment = exact.solve(1, budget);
+    int optimum = 0;
+    for (int b : assignment) optimum = std::max(optimum, b + 1);
+    CHECK(bins == optimum);
+    if (bins < ffd_bins(sizes, capacity)) improved++;
+  }
+  // the random instances do reach the branching, not just the incumbent
+  check_case = "random instances";
+  CHECK(improved > 0);
+  return check_report("branch and bound");
+}
@@ -0,0 +1,94 @@
+// Out-of-core FFD / BFD: the packing of a file of sizes against the packers
+// in memory, and the L2 bound of its size classes against the one of the
+// items.
+
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <functional>
+#include <unistd.h>
+
+#include "filePacking.h"
+#include "check.h"
+
+static std::string temporary(const std::string& name) {
+  return "/tmp/storage_optimisation_" + std::to_string(getpid()) + "_" + name;
+}
+
+template <typename T>
+static void write_file(const std::string& path, const std::vector<int>& sizes) {
+  std::FILE* f = std::fopen(path.c_str(), "wb");
+  for (int s : sizes) {
+    T value = s;
+    std::fwrite(&value, sizeof value, 1, f);
+  }
+  std::fclose(f);
+}
+
+static std::vector<int32_t> read_bins(const std::string& path, std::size_t n) {
+  std::vector<int32_t> bins(n);
+  std::FILE* f = std::fopen(path.c_str(), "rb");
+  CHECK(std::fread(bins.data(), sizeof(int32_t), n, f) == n);
+  std::fclose(f);
+  return bins;
+}
+
+static void check_file(const std::vector<int>& sizes, int capacity, FileSizeType type, bool best_fit) {
+  std::string input = temporary("sizes"), output = temporary("bins");
+  if (type == FILE_INT32) write_file<int32_t>(input, sizes);
+  else write_file<int64_t>(input, sizes);
+
+  FilePacker packer(input, type, capacity);
+  packer.count_classes();
+  packer.pack(best_fit);
+  packer.write_assignment(output);
+
+  std::vector<int> sorted(sizes);
+  std::sort(sorted.begin(), sorted.end(), std::greater<int>());
+  PackingState state(capacity, sorted.size());
+  if (best_fit) pack_best_fit(sorted.data(), sorted.size(), state);
+  else pack_first_fit(sorted.data(), sorted.size(), state);
+  CHECK(packer.num_bins() == state.num_bins());
+  CHECK(packer.bin_loads() == state.load);
+  CHECK(packer.lower_bound() == lower_bound_l2(sorted, capacity));
+
+  // every item is in a bin of its packing, and the loads add up
+  std::vector<int32_t> bins = read_bins(output, sizes.size());
+  std::vector<int> load(packer.num_bins(), 0);
+  for (std::size_t i = 0; i < sizes.size(); i++) {
+    CHECK(bins[i] >= 1 && bins[i] <= packer.num_bins());
+    if (bins[i] >= 1 && bins[i] <= packer.num_bins()) load[bins[i] - 1] += sizes[i];
+  }
+  CHECK(load == packer.bin_loads());
+
+  // the output may not overwrite the input, even through another path
+  bool refused = false;
+  try {
+    packer.write_assignment("/tmp/../" + input.substr(1));
+  } catch (const std::invalid_argument&) {
+    refused = true;
+  }
+  CHECK(refused);
+  std::remove(input.c_str());
+  std::remove(output.c_str());
+}
+
+int main() {
+  std::mt19937 rng(23);
+  const int capacities[] = {10, 150, 1000, 60000, 100000, 2000000};
+  for (int t = 0; t < 60; t++) {
+    int capacity = capacities[t % 6];
+    int n = 1 + rng() % 3000;
+    // few distinct sizes on half of the cases, so that runs are long
+    int high = t % 2 ? std::min(capacity, 12) : capacity;
+    std::vector<int> sizes = random_sizes(rng, n, 0, high);
+    if (t % 4 == 3) for (int& s : sizes) s = std::max(s, capacity / 2 + 1);
+    check_case = "capacity " + std::to_string(capacity) + ", case " + std::to_string(t);
+    check_file(sizes, capacity, t % 3 ? FILE_INT32 : FILE_INT64, t % 2 == 0);
+    check_file(sizes, capacity, FILE_INT32, t % 2 == 1);
+  }
+  return check_report("file packing");
+}
@@ -0,0 +1,73 @@
+// Greedy kernels: pack_first_fit and pack_best_fit, whatever the kernel the
+// capacity selects (uint8_t / uint16_t blocks, buckets, tree, set), give the
+// packing of a plain FFD / BFD scanning every bin, item by item.
+
+#include <string>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <functional>
+
+#include "greedyPacking.h"
+#include "check.h"
+
+// Bin of every item, in the order given: the leftmost bin with enough room,
+// or the fullest one (lowest index among equals)
+static std::vector<int> reference(const std::vector<int>& sizes, int capacity, bool best_fit) {
+  std::vector<int> residual, bin;
+  for (int size : sizes) {
+    int chosen = -1;
+    for (int b = 0; b < (int) residual.size(); b++) {
+      if (residual[b] < size) continue;
+      if (chosen < 0 || (best_fit && residual[b] < residual[chosen])) chosen = b;
+      if (!best_fit) break;
+    }
+    if (chosen < 0) {
+      chosen = residual.size();
+      residual.push_back(capacity);
+    }
+    residual[chosen] -= size;
+    bin.push_back(chosen);
+  }
+  return bin;
+}
+
+static void check_packers(std::vector<int> sizes, int capacity, GreedyKernels& kernels) {
+  std::sort(sizes.begin(), sizes.end(), std::greater<int>());
+  int n = sizes.size();
+  PackingState state(capacity, n);
+
+  pack_first_fit(sizes.data(), n, state, kernels);
+  CHECK(state.assignment == reference(sizes, capacity, false));
+  pack_best_fit(sizes.data(), n, state, kernels);
+  CHECK(state.assignment == reference(sizes, capacity, true));
+
+  // the convenience overloads, on fresh kernels
+  PackingState fresh(capacity, n);
+  pack_best_fit(sizes.data(), n, fresh);
+  CHECK(fresh.assignment == state.assignment);
+}
+
+int main() {
+  std::mt19937 rng(24);
+  // capacities around the kernel limits: uint8_t up to 255, uint16_t and the
+  // buckets up to 65535, then the tree and the set
+  const int capacities[] = {1, 7, 100, 254, 255, 256, 1000, 4096, 4097, 65534, 65535, 65536, 1000000};
+  GreedyKernels kernels; // shared by every case, as a batch does
+  for (int t = 0; t < 1300; t++) {
+    int capacity = capacities[t % 13];
+    int n = rng() % (t % 5 == 0 ? 5000 : 300);
+    std::vector<int> sizes;
+    switch (t % 4) {
+    case 0: sizes = random_sizes(rng, n, 0, capacity); break;                    // with size 0 items
+    case 1: sizes = random_sizes(rng, n, 1, std::max(1, capacity / 3)); break;   // many items per bin
+    case 2: sizes = random_sizes(rng, n, capacity / 2, capacity); break;         // one or two per bin
+    default:                                                                     // few distinct sizes
+      sizes = random_sizes(rng, n, 1, 4);
+      for (int& s : sizes) s = std::max(1, capacity / (s + 1));
+    }
+    check_case = "capacity " + std::to_string(capacity) + ", case " + std::to_string(t);
+    check_packers(sizes, capacity, kernels);
+  }
+  return check_report("greedy kernels");
+}
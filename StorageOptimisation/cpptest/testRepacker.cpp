@@ -0,0 +1,191 @@
+// Incremental repacking: the moves a delta reports are exactly the items whose
+// bin changed, the loads stay those of the items stored, and, while the
+// target does not force bins to be emptied, no stored item moves unless it
+// grew out of its bin (by size: unless the items moved are smaller than it).
+
+#include <string>
+#include <vector>
+#include <random>
+#include <utility>
+#include <algorithm>
+#include <climits>
+
+#include "repacker.h"
+#include "check.h"
+
+// Bin of every stored item, -1 for the others
+static std::vector<int> bins_of(const Repacker& packer) {
+  std::vector<int> bin(packer.num_items(), -1);
+  for (int item = 0; item < packer.num_items(); item++) {
+    if (packer.contains(item)) bin[item] = packer.bin_of(item);
+  }
+  return bin;
+}
+
+static void check_state(const Repacker& packer) {
+  int capacity = packer.bin_capacity();
+  std::vector<long long> load(packer.num_slots(), 0);
+  std::vector<bool> used(packer.num_slots(), false);
+  for (int item = 0; item < packer.num_items(); item++) {
+    if (!packer.contains(item)) continue;
+    load[packer.bin_of(item)] += packer.size_of(item);
+    used[packer.bin_of(item)] = true;
+  }
+  int open = 0;
+  for (int b = 0; b < packer.num_slots(); b++) {
+    CHECK(load[b] == packer.load_of(b));
+    CHECK(load[b] <= capacity);
+    open += used[b];
+  }
+  CHECK(open == packer.num_bins());
+}
+
+// The moves are the items stored before and after the delta whose bin
+// changed, and every new item, from -1
+static void check_moves(const std::vector<Repacker::Move>& moves, const std::vector<int>& before,
+                        const Repacker& packer) {
+  std::vector<int> after = bins_of(packer);
+  std::vector<bool> reported(after.size(), false);
+  for (const Repacker::Move& move : moves) {
+    CHECK(move.to == after[move.item]);
+    CHECK(move.from == (move.item < (int) before.size() ? before[move.item] : -1));
+    reported[move.item] = true;
+  }
+  for (int item = 0; item < (int) after.size(); item++) {
+    if (after[item] < 0) continue;
+    bool changed = item >= (int) before.size() || before[item] != after[item];
+    CHECK(changed == reported[item]);
+  }
+}
+
+// Random delta on a packing: some items removed, some resized, some added
+static void run_delta(Repacker& packer, std::mt19937& rng, int removals, int resizes, int additions,
+                      int low, int high, int target, bool minimal) {
+  int capacity = packer.bin_capacity();
+  std::vector<int> stored;
+  for (int item = 0; item < packer.num_items(); item++) {
+    if (packer.contains(item)) stored.push_back(item);
+  }
+  std::shuffle(stored.begin(), stored.end(), rng);
+  removals = std::min<int>(removals, stored.size());
+  resizes = std::min<int>(resizes, stored.size() - removals);
+  std::vector<int> removed(stored.begin(), stored.begin() + removals);
+  std::vector<std::pair<int, int>> resized;
+  for (int k = 0; k < resizes; k++) {
+    int size = std::uniform_int_distribution<int>(low, std::min(high, capacity))(rng);
+    resized.push_back(std::make_pair(stored[removals + k], size));
+  }
+  std::vector<int> added = random_sizes(rng, additions, low, std::min(high, capacity));
+
+  // what may move: the grown items that no longer fit in their bin
+  std::vector<int> before = bins_of(packer), before_size(packer.num_items());
+  for (int item = 0; item < packer.num_items(); item++) before_size[item] = packer.size_of(item);
+  std::vector<long long> load(packer.num_slots());
+  for (int b = 0; b < packer.num_slots(); b++) load[b] = packer.load_of(b);
+  for (int item : removed) load[before[item]] -= packer.size_of(item);
+  int may_move = 0;
+  long long may_move_size = 0;
+  for (const std::pair<int, int>& change : resized) {
+    int bin = before[change.first];
+    long long grown = load[bin] + change.second - packer.size_of(change.first);
+    if (grown <= capacity) {
+      load[bin] = grown;
+    } else {
+      may_move++;
+      may_move_size += change.second;
+    }
+  }
+
+  int first_added = packer.num_items();
+  std::vector<Repacker::Move> moves = packer.apply(removed, resized, added, target);
+  check_state(packer);
+  check_moves(moves, before, packer);
+  for (int item : removed) CHECK(!packer.contains(item));
+  for (int k = 0; k < additions; k++) CHECK(packer.contains(first_added + k));
+
+  if (minimal) {
+    int moved = 0;
+    long long moved_size = 0;
+    for (const Repacker::Move& move : moves) {
+      if (move.from < 0) continue;
+      moved++;
+      moved_size += std::min(before_size[move.item], packer.size_of(move.item));
+    }
+    // by items, a grown item moves itself; by size, items smaller in total
+    // than its new size may go out instead (at their sizes when they went,
+    // before or after their own resize)
+    CHECK(moved_size <= may_move_size);
+    if (may_move == 0) CHECK(moved == 0);
+  }
+}
+
+int main() {
+  std::mt19937 rng(25);
+  const int capacities[] = {10, 100, 1000, 65536};
+  for (int t = 0; t < 800; t++) {
+    int capacity = capacities[t % 4];
+    Repacker::Cost cost = t % 2 ? Repacker::MOVED_SIZE : Repacker::MOVED_ITEMS;
+    int n = 1 + rng() % 400;
+    int low = 1, high = t % 3 == 0 ? capacity : std::max(1, capacity / 4);
+    std::vector<int> sizes = random_sizes(rng, n, low, high);
+
+    // a feasible start, first fit in input order with gaps between bins
+    std::vector<int> bin(n), residual;
+    for (int i = 0; i < n; i++) {
+      int b = 0;
+      while (b < (int) residual.size() && residual[b] < sizes[i]) b++;
+      if (b == (int) residual.size()) residual.push_back(capacity);
+      residual[b] -= sizes[i];
+      bin[i] = 2 * b;
+    }
+    Repacker packer(capacity, sizes.data(), bin.data(), n, cost);
+    check_case = "capacity " + std::to_string(capacity) + ", case " + std::to_string(t);
+    check_state(packer);
+    CHECK(packer.num_bins() == (int) residual.size());
+
+    for (int round = 0; round < 6; round++) {
+      check_case = "capacity " + std::to_string(capacity) + ", case " + std::to_string(t) +
+                   ", round " + std::to_string(round);
+      switch (round) {
+      case 0: // removals and shrinks only: nothing moves, no bin is added
+        {
+          int bins = packer.num_bins();
+          std::vector<int> stored = bins_of(packer), removed;
+          std::vector<std::pair<int, int>> shrunk;
+          for (int item = 0; item < (int) stored.size(); item++) {
+            if (stored[item] < 0) continue;
+            if (rng() % 5 == 0) removed.push_back(item);
+            else if (rng() % 4 == 0) shrunk.push_back(std::make_pair(item, (packer.size_of(item) + 1) / 2));
+          }
+          std::vector<Repacker::Move> moves = packer.apply(removed, shrunk, std::vector<int>(), 0);
+          CHECK(moves.empty());
+          CHECK(packer.num_bins() <= bins);
+          check_state(packer);
+        }
+        break;
+      case 1: // growth, additions, no target: only what does not fit moves
+        run_delta(packer, rng, 5, 20, 10, low, high, INT_MAX, true);
+        break;
+      case 2: // additions only
+        run_delta(packer, rng, 0, 0, 30, low, high, INT_MAX, true);
+        break;
+      default: // everything, back to as many bins as before
+        run_delta(packer, rng, 10, 10, 10, low, high, 0, false);
+      }
+    }
+  }
+
+  // a grown item that still fits stays; one that does not is the only move
+  {
+    check_case = "single growth";
+    std::vector<int> sizes = {4, 4, 3}, bin = {0, 0, 1};
+    Repacker packer(10, sizes.data(), bin.data(), 3, Repacker::MOVED_ITEMS);
+    std::vector<Repacker::Move> moves = packer.apply({}, {{0, 6}}, {}, INT_MAX);
+    CHECK(moves.empty());
+    CHECK(packer.bin_of(0) == 0);
+    moves = packer.apply({}, {{1, 5}}, {}, INT_MAX);
+    CHECK(moves.size() == 1 && moves[0].item == 1 && moves[0].from == 0 && moves[0].to == 1);
+    check_state(packer);
+  }
+  return check_report("repacker");
+}
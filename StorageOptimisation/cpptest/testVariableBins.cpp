@@ -0,0 +1,90 @@
+// Variable-size bin packing: the branch and bound against an enumeration of
+// every partition of small instances.
+
+#include <cmath>
+#include <string>
+#include <vector>
+#include <random>
+#include <limits>
+#include <functional>
+
+#include "variableBins.h"
+#include "check.h"
+
+// Cheapest cost of the items over every set partition, from the restricted
+// growth strings of the items (block of item i at most 1 + max of the
+// blocks before it)
+static double brute_force(const std::vector<int>& items, const BinCatalogue& catalogue) {
+  int n = items.size();
+  std::vector<int> block(n, 0), load;
+  double best = std::numeric_limits<double>::infinity();
+  std::function<void(int)> visit = [&](int i) {
+    if (i == n) {
+      double total = 0;
+      for (int l : load) total += catalogue.cost_for(l);
+      best = std::min(best, total);
+      return;
+    }
+    for (int b = 0; b <= (int) load.size(); b++) {
+      bool open = b == (int) load.size();
+      if (open) load.push_back(0);
+      if (load[b] + items[i] <= catalogue.largest()) {
+        load[b] += items[i];
+        visit(i + 1);
+        load[b] -= items[i];
+      }
+      if (open) load.pop_back();
+    }
+  };
+  visit(0);
+  return best;
+}
+
+static void check_solver(const std::vector<int>& items, const std::vector<int>& capacities,
+                         const std::vector<double>& costs) {
+  BinCatalogue catalogue(capacities, costs);
+  VariableBinSolver solver(items, catalogue);
+  SearchBudget budget;
+  std::vector<int> bin = solver.solve(budget);
+  double expected = brute_force(items, catalogue);
+  CHECK(solver.optimal());
+  CHECK(std::fabs(solver.cost() - expected) < 1e-9);
+
+  // the packing is feasible and costs what is reported
+  std::vector<long long> load(solver.loads().size(), 0);
+  for (int k = 0; k < (int) bin.size(); k++) load[bin[k]] += items[solver.sorted_items()[k]];
+  double total = 0;
+  for (int b = 0; b < (int) load.size(); b++) {
+    CHECK(load[b] == solver.loads()[b]);
+    CHECK(load[b] <= catalogue.largest());
+    total += catalogue.cost_for(load[b]);
+  }
+  CHECK(std::fabs(total - solver.cost()) < 1e-9);
+}
+
+int main() {
+  // regressions: the room the open bins pay for was rounded down, e.g. 2 /
+  // (2 / 6) is 5.999999999999999 and 2.2 / 0.575 is not a whole number,
+  // and the bound cut the optimal branch
+  check_case = "inexact costs";
+  check_solver({1, 5, 3, 1, 5, 1}, {5, 6}, {1.9, 2.0});
+  check_solver({4, 1, 3, 1, 3, 2}, {4, 3}, {2.3, 2.2});
+  check_solver({4, 3, 3, 5, 2, 1, 5}, {4, 5}, {2.3, 2.5});
+  check_solver({2, 4, 3, 1, 1, 3}, {3, 2, 4, 1}, {1.8, 2.2, 1.9, 1.9});
+
+  std::mt19937 rng(2024);
+  for (int t = 0; t < 20000; t++) {
+    int types = 1 + rng() % 4;
+    std::vector<int> capacities(types);
+    std::vector<double> costs(types);
+    for (int k = 0; k < types; k++) {
+      capacities[k] = 1 + rng() % 12;
+      costs[k] = (1 + rng() % 25) * 0.1;
+    }
+    int largest = *std::max_element(capacities.begin(), capacities.end());
+    std::vector<int> items = random_sizes(rng, 1 + rng() % 7, 1, largest);
+    check_case = "random instance " + std::to_string(t);
+    check_solver(items, capacities, costs);
+  }
+  return check_report("variable bins");
+}
@@ -10,47 +10,352 @@ Rcpp::Rostream<true>&  Rcpp::Rcout = Rcpp::Rcpp_cout_get();
 Rcpp::Rostream<false>& Rcpp::Rcerr = Rcpp::Rcpp_cerr_get();
 #endif
 
+// pack_flat_Rcpp
+IntegerVector pack_flat_Rcpp(SEXP games, int storage, std::string algorithm, bool loads);
+RcppExport SEXP _StorageOptimisation_pack_flat_Rcpp(SEXP gamesSEXP, SEXP storageSEXP, SEXP algorithmSEXP, SEXP loadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< SEXP >::type games(gamesSEXP);
+    Rcpp::traits::input_parameter< int >::type storage(storageSEXP);
+    Rcpp::traits::input_parameter< std::string >::type algorithm(algorithmSEXP);
+    Rcpp::traits::input_parameter< bool >::type loads(loadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(pack_flat_Rcpp(games, storage, algorithm, loads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// bins_list_Rcpp
+List bins_list_Rcpp(SEXP games, SEXP bin);
+RcppExport SEXP _StorageOptimisation_bins_list_Rcpp(SEXP gamesSEXP, SEXP binSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< SEXP >::type games(gamesSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type bin(binSEXP);
+    rcpp_result_gen = Rcpp::wrap(bins_list_Rcpp(games, bin));
+    return rcpp_result_gen;
+END_RCPP
+}
+// pack_batch_Rcpp
+List pack_batch_Rcpp(SEXP sizes, IntegerVector offsets, IntegerVector capacities, std::string algorithm, int threads);
+RcppExport SEXP _StorageOptimisation_pack_batch_Rcpp(SEXP sizesSEXP, SEXP offsetsSEXP, SEXP capacitiesSEXP, SEXP algorithmSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< SEXP >::type sizes(sizesSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type offsets(offsetsSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type capacities(capacitiesSEXP);
+    Rcpp::traits::input_parameter< std::string >::type algorithm(algorithmSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(pack_batch_Rcpp(sizes, offsets, capacities, algorithm, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// bfd_bin_packing_Rcpp
+List bfd_bin_packing_Rcpp(SEXP games, int storage);
+RcppExport SEXP _StorageOptimisation_bfd_bin_packing_Rcpp(SEXP gamesSEXP, SEXP storageSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type games(gamesSEXP);
+    Rcpp::traits::input_parameter< int >::type storage(storageSEXP);
+    rcpp_result_gen = Rcpp::wrap(bfd_bin_packing_Rcpp(games, storage));
+    return rcpp_result_gen;
+END_RCPP
+}
+// solve_bin_packing_parallel
+IntegerVector solve_bin_packing_parallel(SEXP c, int max_bin_size, int threads, double time_limit, double max_nodes, Nullable<Function> progress);
+RcppExport SEXP _StorageOptimisation_solve_bin_packing_parallel(SEXP cSEXP, SEXP max_bin_sizeSEXP, SEXP threadsSEXP, SEXP time_limitSEXP, SEXP max_nodesSEXP, SEXP progressSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type c(cSEXP);
+    Rcpp::traits::input_parameter< int >::type max_bin_size(max_bin_sizeSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< double >::type time_limit(time_limitSEXP);
+    Rcpp::traits::input_parameter< double >::type max_nodes(max_nodesSEXP);
+    Rcpp::traits::input_parameter< Nullable<Function> >::type progress(progressSEXP);
+    rcpp_result_gen = Rcpp::wrap(solve_bin_packing_parallel(c, max_bin_size, threads, time_limit, max_nodes, progress));
+    return rcpp_result_gen;
+END_RCPP
+}
+// exact_bin_packing_Rcpp
+List exact_bin_packing_Rcpp(SEXP c, int max_bin_size, int threads, double time_limit, double max_nodes, Nullable<Function> progress);
+RcppExport SEXP _StorageOptimisation_exact_bin_packing_Rcpp(SEXP cSEXP, SEXP max_bin_sizeSEXP, SEXP threadsSEXP, SEXP time_limitSEXP, SEXP max_nodesSEXP, SEXP progressSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type c(cSEXP);
+    Rcpp::traits::input_parameter< int >::type max_bin_size(max_bin_sizeSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< double >::type time_limit(time_limitSEXP);
+    Rcpp::traits::input_parameter< double >::type max_nodes(max_nodesSEXP);
+    Rcpp::traits::input_parameter< Nullable<Function> >::type progress(progressSEXP);
+    rcpp_result_gen = Rcpp::wrap(exact_bin_packing_Rcpp(c, max_bin_size, threads, time_limit, max_nodes, progress));
+    return rcpp_result_gen;
+END_RCPP
+}
 // ffd_bin_packing_Rcpp
-std::vector<std::vector<int>> ffd_bin_packing_Rcpp(std::vector<int>& games, int storage);
+List ffd_bin_packing_Rcpp(SEXP games, int storage);
 RcppExport SEXP _StorageOptimisation_ffd_bin_packing_Rcpp(SEXP gamesSEXP, SEXP storageSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< std::vector<int>& >::type games(gamesSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type games(gamesSEXP);
     Rcpp::traits::input_parameter< int >::type storage(storageSEXP);
     rcpp_result_gen = Rcpp::wrap(ffd_bin_packing_Rcpp(games, storage));
     return rcpp_result_gen;
 END_RCPP
 }
+// ffd_tree_Rcpp
+List ffd_tree_Rcpp(SEXP games, int storage);
+RcppExport SEXP _StorageOptimisation_ffd_tree_Rcpp(SEXP gamesSEXP, SEXP storageSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type games(gamesSEXP);
+    Rcpp::traits::input_parameter< int >::type storage(storageSEXP);
+    rcpp_result_gen = Rcpp::wrap(ffd_tree_Rcpp(games, storage));
+    return rcpp_result_gen;
+END_RCPP
+}
+// pack_file_Rcpp
+List pack_file_Rcpp(std::string input, std::string output, int storage, std::string type, std::string algorithm);
+RcppExport SEXP _StorageOptimisation_pack_file_Rcpp(SEXP inputSEXP, SEXP outputSEXP, SEXP storageSEXP, SEXP typeSEXP, SEXP algorithmSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< std::string >::type input(inputSEXP);
+    Rcpp::traits::input_parameter< std::string >::type output(outputSEXP);
+    Rcpp::traits::input_parameter< int >::type storage(storageSEXP);
+    Rcpp::traits::input_parameter< std::string >::type type(typeSEXP);
+    Rcpp::traits::input_parameter< std::string >::type algorithm(algorithmSEXP);
+    rcpp_result_gen = Rcpp::wrap(pack_file_Rcpp(input, output, storage, type, algorithm));
+    return rcpp_result_gen;
+END_RCPP
+}
+// improve_packing_Rcpp
+List improve_packing_Rcpp(SEXP games, int storage, IntegerVector assignment, double time_limit, int seed, Nullable<Function> progress);
+RcppExport SEXP _StorageOptimisation_improve_packing_Rcpp(SEXP gamesSEXP, SEXP storageSEXP, SEXP assignmentSEXP, SEXP time_limitSEXP, SEXP seedSEXP, SEXP progressSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type games(gamesSEXP);
+    Rcpp::traits::input_parameter< int >::type storage(storageSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type assignment(assignmentSEXP);
+    Rcpp::traits::input_parameter< double >::type time_limit(time_limitSEXP);
+    Rcpp::traits::input_parameter< int >::type seed(seedSEXP);
+    Rcpp::traits::input_parameter< Nullable<Function> >::type progress(progressSEXP);
+    rcpp_result_gen = Rcpp::wrap(improve_packing_Rcpp(games, storage, assignment, time_limit, seed, progress));
+    return rcpp_result_gen;
+END_RCPP
+}
+// online_packer_Rcpp
+SEXP online_packer_Rcpp(int storage, std::string policy, int classes);
+RcppExport SEXP _StorageOptimisation_online_packer_Rcpp(SEXP storageSEXP, SEXP policySEXP, SEXP classesSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< int >::type storage(storageSEXP);
+    Rcpp::traits::input_parameter< std::string >::type policy(policySEXP);
+    Rcpp::traits::input_parameter< int >::type classes(classesSEXP);
+    rcpp_result_gen = Rcpp::wrap(online_packer_Rcpp(storage, policy, classes));
+    return rcpp_result_gen;
+END_RCPP
+}
+// online_add_Rcpp
+List online_add_Rcpp(SEXP packer, SEXP sizes);
+RcppExport SEXP _StorageOptimisation_online_add_Rcpp(SEXP packerSEXP, SEXP sizesSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< SEXP >::type packer(packerSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type sizes(sizesSEXP);
+    rcpp_result_gen = Rcpp::wrap(online_add_Rcpp(packer, sizes));
+    return rcpp_result_gen;
+END_RCPP
+}
+// online_remove_Rcpp
+void online_remove_Rcpp(SEXP packer, IntegerVector items);
+RcppExport SEXP _StorageOptimisation_online_remove_Rcpp(SEXP packerSEXP, SEXP itemsSEXP) {
+BEGIN_RCPP
+    Rcpp::traits::input_parameter< SEXP >::type packer(packerSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type items(itemsSEXP);
+    online_remove_Rcpp(packer, items);
+    return R_NilValue;
+END_RCPP
+}
+// online_snapshot_Rcpp
+List online_snapshot_Rcpp(SEXP packer);
+RcppExport SEXP _StorageOptimisation_online_snapshot_Rcpp(SEXP packerSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< SEXP >::type packer(packerSEXP);
+    rcpp_result_gen = Rcpp::wrap(online_snapshot_Rcpp(packer));
+    return rcpp_result_gen;
+END_RCPP
+}
+// pack_Rcpp
+List pack_Rcpp(SEXP games, int storage, int threads, double time_limit, double max_nodes, int seed, Nullable<Function> progress);
+RcppExport SEXP _StorageOptimisation_pack_Rcpp(SEXP gamesSEXP, SEXP storageSEXP, SEXP threadsSEXP, SEXP time_limitSEXP, SEXP max_nodesSEXP, SEXP seedSEXP, SEXP progressSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type games(gamesSEXP);
+    Rcpp::traits::input_parameter< int >::type storage(storageSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< double >::type time_limit(time_limitSEXP);
+    Rcpp::traits::input_parameter< double >::type max_nodes(max_nodesSEXP);
+    Rcpp::traits::input_parameter< int >::type seed(seedSEXP);
+    Rcpp::traits::input_parameter< Nullable<Function> >::type progress(progressSEXP);
+    rcpp_result_gen = Rcpp::wrap(pack_Rcpp(games, storage, threads, time_limit, max_nodes, seed, progress));
+    return rcpp_result_gen;
+END_RCPP
+}
+// repacker_Rcpp
+SEXP repacker_Rcpp(SEXP sizes, IntegerVector assignment, int storage, std::string cost);
+RcppExport SEXP _StorageOptimisation_repacker_Rcpp(SEXP sizesSEXP, SEXP assignmentSEXP, SEXP storageSEXP, SEXP costSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< SEXP >::type sizes(sizesSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type assignment(assignmentSEXP);
+    Rcpp::traits::input_parameter< int >::type storage(storageSEXP);
+    Rcpp::traits::input_parameter< std::string >::type cost(costSEXP);
+    rcpp_result_gen = Rcpp::wrap(repacker_Rcpp(sizes, assignment, storage, cost));
+    return rcpp_result_gen;
+END_RCPP
+}
+// repack_Rcpp
+List repack_Rcpp(SEXP repacker, SEXP add, IntegerVector remove, IntegerVector resize, SEXP new_sizes, int target);
+RcppExport SEXP _StorageOptimisation_repack_Rcpp(SEXP repackerSEXP, SEXP addSEXP, SEXP removeSEXP, SEXP resizeSEXP, SEXP new_sizesSEXP, SEXP targetSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< SEXP >::type repacker(repackerSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type add(addSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type remove(removeSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type resize(resizeSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type new_sizes(new_sizesSEXP);
+    Rcpp::traits::input_parameter< int >::type target(targetSEXP);
+    rcpp_result_gen = Rcpp::wrap(repack_Rcpp(repacker, add, remove, resize, new_sizes, target));
+    return rcpp_result_gen;
+END_RCPP
+}
+// repacker_snapshot_Rcpp
+List repacker_snapshot_Rcpp(SEXP repacker);
+RcppExport SEXP _StorageOptimisation_repacker_snapshot_Rcpp(SEXP repackerSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< SEXP >::type repacker(repackerSEXP);
+    rcpp_result_gen = Rcpp::wrap(repacker_snapshot_Rcpp(repacker));
+    return rcpp_result_gen;
+END_RCPP
+}
+// storage_lower_bounds
+IntegerVector storage_lower_bounds(SEXP j, int mem);
+RcppExport SEXP _StorageOptimisation_storage_lower_bounds(SEXP jSEXP, SEXP memSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type j(jSEXP);
+    Rcpp::traits::input_parameter< int >::type mem(memSEXP);
+    rcpp_result_gen = Rcpp::wrap(storage_lower_bounds(j, mem));
+    return rcpp_result_gen;
+END_RCPP
+}
 // naive_storage_Rcpp
-std::vector<std::vector<int>> naive_storage_Rcpp(std::vector<int> j, int mem);
-RcppExport SEXP _StorageOptimisation_naive_storage_Rcpp(SEXP jSEXP, SEXP memSEXP) {
+List naive_storage_Rcpp(SEXP j, int mem, double time_limit, double max_permutations, Nullable<Function> progress);
+RcppExport SEXP _StorageOptimisation_naive_storage_Rcpp(SEXP jSEXP, SEXP memSEXP, SEXP time_limitSEXP, SEXP max_permutationsSEXP, SEXP progressSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< std::vector<int> >::type j(jSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type j(jSEXP);
     Rcpp::traits::input_parameter< int >::type mem(memSEXP);
-    rcpp_result_gen = Rcpp::wrap(naive_storage_Rcpp(j, mem));
+    Rcpp::traits::input_parameter< double >::type time_limit(time_limitSEXP);
+    Rcpp::traits::input_parameter< double >::type max_permutations(max_permutationsSEXP);
+    Rcpp::traits::input_parameter< Nullable<Function> >::type progress(progressSEXP);
+    rcpp_result_gen = Rcpp::wrap(naive_storage_Rcpp(j, mem, time_limit, max_permutations, progress));
     return rcpp_result_gen;
 END_RCPP
 }
 // solve_bin_packing
-std::vector<int> solve_bin_packing(std::vector<int> c, int max_bin_size);
-RcppExport SEXP _StorageOptimisation_solve_bin_packing(SEXP cSEXP, SEXP max_bin_sizeSEXP) {
+IntegerVector solve_bin_packing(SEXP c, int max_bin_size, double time_limit, double max_nodes, Nullable<Function> progress);
+RcppExport SEXP _StorageOptimisation_solve_bin_packing(SEXP cSEXP, SEXP max_bin_sizeSEXP, SEXP time_limitSEXP, SEXP max_nodesSEXP, SEXP progressSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< std::vector<int> >::type c(cSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type c(cSEXP);
     Rcpp::traits::input_parameter< int >::type max_bin_size(max_bin_sizeSEXP);
-    rcpp_result_gen = Rcpp::wrap(solve_bin_packing(c, max_bin_size));
+    Rcpp::traits::input_parameter< double >::type time_limit(time_limitSEXP);
+    Rcpp::traits::input_parameter< double >::type max_nodes(max_nodesSEXP);
+    Rcpp::traits::input_parameter< Nullable<Function> >::type progress(progressSEXP);
+    rcpp_result_gen = Rcpp::wrap(solve_bin_packing(c, max_bin_size, time_limit, max_nodes, progress));
+    return rcpp_result_gen;
+END_RCPP
+}
+// dp_storage_Rcpp
+List dp_storage_Rcpp(SEXP j, int mem, double time_limit, Nullable<Function> progress);
+RcppExport SEXP _StorageOptimisation_dp_storage_Rcpp(SEXP jSEXP, SEXP memSEXP, SEXP time_limitSEXP, SEXP progressSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type j(jSEXP);
+    Rcpp::traits::input_parameter< int >::type mem(memSEXP);
+    Rcpp::traits::input_parameter< double >::type time_limit(time_limitSEXP);
+    Rcpp::traits::input_parameter< Nullable<Function> >::type progress(progressSEXP);
+    rcpp_result_gen = Rcpp::wrap(dp_storage_Rcpp(j, mem, time_limit, progress));
+    return rcpp_result_gen;
+END_RCPP
+}
+// variable_bin_packing_Rcpp
+List variable_bin_packing_Rcpp(SEXP games, IntegerVector capacities, NumericVector costs, double time_limit, double max_nodes, Nullable<Function> progress);
+RcppExport SEXP _StorageOptimisation_variable_bin_packing_Rcpp(SEXP gamesSEXP, SEXP capacitiesSEXP, SEXP costsSEXP, SEXP time_limitSEXP, SEXP max_nodesSEXP, SEXP progressSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type games(gamesSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type capacities(capacitiesSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type costs(costsSEXP);
+    Rcpp::traits::input_parameter< double >::type time_limit(time_limitSEXP);
+    Rcpp::traits::input_parameter< double >::type max_nodes(max_nodesSEXP);
+    Rcpp::traits::input_parameter< Nullable<Function> >::type progress(progressSEXP);
+    rcpp_result_gen = Rcpp::wrap(variable_bin_packing_Rcpp(games, capacities, costs, time_limit, max_nodes, progress));
+    return rcpp_result_gen;
+END_RCPP
+}
+// vector_bin_packing_Rcpp
+List vector_bin_packing_Rcpp(IntegerMatrix demands, IntegerVector capacities, std::string order, int threads, int shard_items);
+RcppExport SEXP _StorageOptimisation_vector_bin_packing_Rcpp(SEXP demandsSEXP, SEXP capacitiesSEXP, SEXP orderSEXP, SEXP threadsSEXP, SEXP shard_itemsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< IntegerMatrix >::type demands(demandsSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type capacities(capacitiesSEXP);
+    Rcpp::traits::input_parameter< std::string >::type order(orderSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< int >::type shard_items(shard_itemsSEXP);
+    rcpp_result_gen = Rcpp::wrap(vector_bin_packing_Rcpp(demands, capacities, order, threads, shard_items));
     return rcpp_result_gen;
 END_RCPP
 }
 
 static const R_CallMethodDef CallEntries[] = {
+    {"_StorageOptimisation_pack_flat_Rcpp", (DL_FUNC) &_StorageOptimisation_pack_flat_Rcpp, 4},
+    {"_StorageOptimisation_bins_list_Rcpp", (DL_FUNC) &_StorageOptimisation_bins_list_Rcpp, 2},
+    {"_StorageOptimisation_pack_batch_Rcpp", (DL_FUNC) &_StorageOptimisation_pack_batch_Rcpp, 5},
+    {"_StorageOptimisation_bfd_bin_packing_Rcpp", (DL_FUNC) &_StorageOptimisation_bfd_bin_packing_Rcpp, 2},
+    {"_StorageOptimisation_solve_bin_packing_parallel", (DL_FUNC) &_StorageOptimisation_solve_bin_packing_parallel, 6},
+    {"_StorageOptimisation_exact_bin_packing_Rcpp", (DL_FUNC) &_StorageOptimisation_exact_bin_packing_Rcpp, 6},
     {"_StorageOptimisation_ffd_bin_packing_Rcpp", (DL_FUNC) &_StorageOptimisation_ffd_bin_packing_Rcpp, 2},
-    {"_StorageOptimisation_naive_storage_Rcpp", (DL_FUNC) &_StorageOptimisation_naive_storage_Rcpp, 2},
-    {"_StorageOptimisation_solve_bin_packing", (DL_FUNC) &_StorageOptimisation_solve_bin_packing, 2},
+    {"_StorageOptimisation_ffd_tree_Rcpp", (DL_FUNC) &_StorageOptimisation_ffd_tree_Rcpp, 2},
+    {"_StorageOptimisation_pack_file_Rcpp", (DL_FUNC) &_StorageOptimisation_pack_file_Rcpp, 5},
+    {"_StorageOptimisation_improve_packing_Rcpp", (DL_FUNC) &_StorageOptimisation_improve_packing_Rcpp, 6},
+    {"_StorageOptimisation_online_packer_Rcpp", (DL_FUNC) &_StorageOptimisation_online_packer_Rcpp, 3},
+    {"_StorageOptimisation_online_add_Rcpp", (DL_FUNC) &_StorageOptimisation_online_add_Rcpp, 2},
+    {"_StorageOptimisation_online_remove_Rcpp", (DL_FUNC) &_StorageOptimisation_online_remove_Rcpp, 2},
+    {"_StorageOptimisation_online_snapshot_Rcpp", (DL_FUNC) &_StorageOptimisation_online_snapshot_Rcpp, 1},
+    {"_StorageOptimisation_pack_Rcpp", (DL_FUNC) &_StorageOptimisation_pack_Rcpp, 7},
+    {"_StorageOptimisation_repacker_Rcpp", (DL_FUNC) &_StorageOptimisation_repacker_Rcpp, 4},
+    {"_StorageOptimisation_repack_Rcpp", (DL_FUNC) &_StorageOptimisation_repack_Rcpp, 6},
+    {"_StorageOptimisation_repacker_snapshot_Rcpp", (DL_FUNC) &_StorageOptimisation_repacker_snapshot_Rcpp, 1},
+    {"_StorageOptimisation_storage_lower_bounds", (DL_FUNC) &_StorageOptimisation_storage_lower_bounds, 2},
+    {"_StorageOptimisation_naive_storage_Rcpp", (DL_FUNC) &_StorageOptimisation_naive_storage_Rcpp, 5},
+    {"_StorageOptimisation_solve_bin_packing", (DL_FUNC) &_StorageOptimisation_solve_bin_packing, 5},
+    {"_StorageOptimisation_dp_storage_Rcpp", (DL_FUNC) &_StorageOptimisation_dp_storage_Rcpp, 4},
+    {"_StorageOptimisation_variable_bin_packing_Rcpp", (DL_FUNC) &_StorageOptimisation_variable_bin_packing_Rcpp, 6},
+    {"_StorageOptimisation_vector_bin_packing_Rcpp", (DL_FUNC) &_StorageOptimisation_vector_bin_packing_Rcpp, 5},
     {NULL, NULL, 0}
 };
 
@@ -0,0 +1,152 @@
+#include <Rcpp.h>
+using namespace Rcpp;
+using namespace std;
+
+#include <vector>
+#include <string>
+#include <thread>
+#include <climits>
+
+#include "batchPacking.h"
+#include "rInterface.h"
+
+static BatchAlgorithm parse_algorithm(const std::string& algorithm) {
+  if (algorithm == "ffd") return BATCH_FFD;
+  if (algorithm == "bfd") return BATCH_BFD;
+  stop("unknown algorithm '%s', use \"ffd\" or \"bfd\"", algorithm);
+}
+
+//' Flat bin packing using C++
+//'
+//' Packs the games with first-fit or best-fit decreasing and returns the
+//' storage of every game instead of a nested list. The sizes are read in
+//' place from the R vector (ALTREP sequences are not materialised) and only
+//' an index array is sorted, so large inputs are neither copied nor
+//' converted. \code{bins_list_Rcpp} builds the nested list when needed.
+//' @param games an integer (or whole-number numeric) vector of games' sizes
+//' @param storage the storage size
+//' @param algorithm \code{"ffd"} (first-fit decreasing) or \code{"bfd"}
+//'        (best-fit decreasing)
+//' @param loads whether to attach the load of every storage
+//' @return an integer vector with the storage of every game, numbered from
+//'         1, with a \code{num_bins} attribute, a \code{stats} attribute
+//'         timing its phases and, if requested, a \code{loads} attribute
+//' @export
+// [[Rcpp::export(rng = false)]]
+IntegerVector pack_flat_Rcpp(SEXP games, int storage, std::string algorithm = "ffd", bool loads = false) {
+  SearchStats stats;
+  BatchAlgorithm engine = parse_algorithm(algorithm);
+  IntegerInput sizes(games);
+  if (sizes.size() > INT_MAX) {
+    stop("at most %d games can be packed at once", INT_MAX);
+  }
+  int n = sizes.size();
+  check_sizes(sizes.data(), n, storage);
+
+  IntegerVector bin(n);
+  BatchScratch scratch;
+  stats.lap(stats.setup_seconds);
+  int num_bins = pack_instance(sizes.data(), n, storage, engine, scratch, bin.begin());
+  stats.lap(stats.search_seconds);
+  for (int& b : bin) b++;
+
+  bin.attr("num_bins") = num_bins;
+  if (loads) {
+    bin.attr("loads") = IntegerVector(scratch.state.load.begin(), scratch.state.load.end());
+  }
+  set_stats(bin, stats);
+  return bin;
+}
+
+//' Nested storages from a flat packing
+//'
+//' Builds the list returned by the other packing functions (one vector of
+//' games' sizes per storage) from the storage of every game, as returned by
+//' \code{pack_flat_Rcpp}.
+//' @param games the games' sizes
+//' @param bin the storage of every game, numbered from 1
+//' @return A list of vectors representing the storages, where each inner
+//'         vector contains the sizes of the games stored in it.
+//' @export
+// [[Rcpp::export(rng = false)]]
+List bins_list_Rcpp(SEXP games, SEXP bin) {
+  IntegerInput sizes(games), bins(bin);
+  if (sizes.size() != bins.size()) {
+    stop("games and bin must have the same length");
+  }
+  int num_bins = 0;
+  for (R_xlen_t i = 0; i < bins.size(); i++) {
+    if (bins[i] < 1) stop("storages are numbered from 1");
+    num_bins = max(num_bins, bins[i]);
+  }
+  return bins_list(sizes.data(), bins.data(), sizes.size(), num_bins, 1);
+}
+
+//' Batch bin packing using C++
+//'
+//' Packs many independent instances in a single call. The instances are given
+//' in CSR form: the games of instance k are
+//' \code{sizes[(offsets[k] + 1):offsets[k + 1]]}. They are packed in
+//' parallel, each worker thread reusing its own buffers, and the result comes
+//' back as two flat vectors instead of one nested list per instance. See
+//' \code{pack_batch} to pack a list of instances.
+//' @param sizes the games' sizes of every instance, one after the other
+//' @param offsets the start of every instance in \code{sizes} (from 0),
+//'        followed by the length of \code{sizes}
+//' @param capacities the storage size of every instance, or a single size
+//'        used by all of them
+//' @param algorithm \code{"ffd"} (first-fit decreasing) or \code{"bfd"}
+//'        (best-fit decreasing)
+//' @param threads number of worker threads, 0 to use every core
+//' @return a list with \code{bin}, the storage of every game (numbered from 1
+//'         within its instance, aligned with \code{sizes}), and
+//'         \code{num_bins}, the number of storages of every instance, with
+//'         a \code{stats} attribute timing the phases of the whole batch
+//' @export
+// [[Rcpp::export(rng = false)]]
+List pack_batch_Rcpp(SEXP sizes, IntegerVector offsets, IntegerVector capacities,
+                     std::string algorithm = "ffd", int threads = 0) {
+  SearchStats stats;
+  BatchAlgorithm engine = parse_algorithm(algorithm);
+  IntegerInput games(sizes);
+
+  int num_instances = offsets.size() - 1;
+  if (num_instances < 0 || offsets[0] != 0 || offsets[num_instances] != games.size()) {
+    stop("offsets must start at 0 and end with the number of sizes");
+  }
+  if (capacities.size() != 1 && capacities.size() != num_instances) {
+    stop("capacities must hold one storage size, or one per instance");
+  }
+  // every offset checked before any size is read through them
+  for (int k = 0; k < num_instances; k++) {
+    if (offsets[k + 1] == NA_INTEGER || offsets[k + 1] < offsets[k] || offsets[k + 1] > games.size()) {
+      stop("offsets must be non-decreasing");
+    }
+  }
+  std::vector<int> capacity(num_instances);
+  for (int k = 0; k < num_instances; k++) {
+    capacity[k] = capacities[capacities.size() == 1 ? 0 : k];
+    if (capacity[k] == NA_INTEGER || capacity[k] <= 0) {
+      stop("the storage size of instance %d must be positive", k + 1);
+    }
+    for (int i = offsets[k]; i < offsets[k + 1]; i++) {
+      if (games[i] == NA_INTEGER) stop("the size of game %d is NA", i + 1);
+      if (games[i] < 0 || games[i] > capacity[k]) {
+        stop("game %d does not fit in an empty storage of instance %d", i + 1, k + 1);
+      }
+    }
+  }
+
+  IntegerVector bin(games.size());
+  IntegerVector num_bins(num_instances);
+  if (threads <= 0) threads = max(1u, thread::hardware_concurrency());
+  stats.lap(stats.setup_seconds);
+  pack_batch(games.data(), offsets.begin(), num_instances, capacity.data(), engine, threads,
+             bin.begin(), num_bins.begin());
+  stats.lap(stats.search_seconds);
+
+  for (int& b : bin) b++;
+  List result = List::create(Named("bin") = bin, Named("num_bins") = num_bins);
+  set_stats(result, stats);
+  return result;
+}
@@ -0,0 +1,73 @@
+#ifndef BATCH_PACKING_H
+#define BATCH_PACKING_H
+
+#include <vector>
+#include <algorithm>
+#include <utility>
+
+#include "packingState.h"
+#include "greedyPacking.h"
+#include "workStealingPool.h"
+#include "indexSort.h"
+
+enum BatchAlgorithm { BATCH_FFD, BATCH_BFD };
+
+// Working memory of one worker, reused from one instance to the next so that
+// packing a small instance does not allocate once the buffers have grown
+struct BatchScratch {
+  std::vector<int> order;  // items of the instance by decreasing size
+  std::vector<int> sorted; // their sizes
+  IndexSorter sorter;
+  PackingState state;
+  GreedyKernels kernels;
+
+  BatchScratch() : state(0, 0) {}
+};
+
+// Packs one instance and writes the bin of each item (numbered from 0, in
+// the order of `sizes`) to `bins`. Returns the number of bins.
+inline int pack_instance(const int* sizes, int n, int capacity, BatchAlgorithm algorithm,
+                         BatchScratch& scratch, int* bins) {
+  scratch.sorter.sort(sizes, n, scratch.order);
+  scratch.sorted.resize(n);
+  for (int k = 0; k < n; k++) scratch.sorted[k] = sizes[scratch.order[k]];
+
+  scratch.state.capacity = capacity;
+  if (algorithm == BATCH_FFD) {
+    pack_first_fit(scratch.sorted.data(), n, scratch.state, scratch.kernels);
+  } else {
+    pack_best_fit(scratch.sorted.data(), n, scratch.state, scratch.kernels);
+  }
+  for (int k = 0; k < n; k++) bins[scratch.order[k]] = scratch.state.assignment[k];
+  return scratch.state.num_bins();
+}
+
+// Packs the instances of a CSR batch: instance k holds the items
+// offsets[k] .. offsets[k + 1] - 1 of `sizes` and has capacity
+// capacities[k]. Instances are handed out in chunks to a work-stealing pool
+// and each worker keeps its own scratch space. The bin of every item goes to
+// bins (aligned with sizes) and the bin count of every instance to
+// num_bins. No R API is used, the buffers may point into R vectors.
+inline void pack_batch(const int* sizes, const int* offsets, int num_instances,
+                       const int* capacities, BatchAlgorithm algorithm, int threads,
+                       int* bins, int* num_bins) {
+  WorkStealingPool<std::pair<int, int>> pool(threads);
+  std::vector<BatchScratch> scratch(pool.size());
+
+  // about 8 chunks per worker, so that stealing can even out the load
+  int chunk = std::max(1, num_instances / (8 * pool.size()));
+  int worker = 0;
+  for (int first = 0; first < num_instances; first += chunk) {
+    pool.push(worker, std::make_pair(first, std::min(num_instances, first + chunk)));
+    worker = (worker + 1) % pool.size();
+  }
+
+  pool.run([&](std::pair<int, int>& range, int w) {
+    for (int k = range.first; k < range.second; k++) {
+      num_bins[k] = pack_instance(sizes + offsets[k], offsets[k + 1] - offsets[k], capacities[k],
+                                  algorithm, scratch[w], bins + offsets[k]);
+    }
+  });
+}
+
+#endif
@@ -0,0 +1,41 @@
+#include <Rcpp.h>
+using namespace Rcpp;
+using namespace std;
+
+#include <vector>
+#include <algorithm>
+#include <functional>
+
+#include "packingState.h"
+#include "greedyPacking.h"
+#include "rInterface.h"
+
+//' Best-fit-decreasing bin packing algorithm
+//'
+//' Games are taken by decreasing size and each one goes into the fullest bin
+//' that can still hold it, found in O(log n) in a balanced tree of the bins
+//' ordered by residual capacity. A new bin is opened only when no bin fits.
+//' @param games A vector containing the sizes of items to be packed.
+//' @param storage The maximum capacity of each bin.
+//' @return A list of vectors representing the bins, where each inner vector
+//'         contains the sizes of items packed into a single bin, with an
+//'         \code{assignment} attribute giving the bin of every item, in
+//'         input order, numbered from 1, and a \code{stats} attribute
+//'         timing its phases.
+//' @export
+// [[Rcpp::export]]
+List bfd_bin_packing_Rcpp(SEXP games, int storage)
+{
+    SearchStats stats;
+    SortedInput input(games, storage);
+    stats.lap(stats.setup_seconds);
+
+    PackingState state(storage, input.sizes.size());
+    pack_best_fit(input.sizes.data(), input.sizes.size(), state);
+    stats.lap(stats.search_seconds);
+
+    List bins = bins_list(state, input.sizes);
+    bins.attr("assignment") = input_assignment(state.assignment, input.input_index);
+    set_stats(bins, stats);
+    return bins;
+}
@@ -0,0 +1,169 @@
+#ifndef BRANCH_AND_BOUND_H
+#define BRANCH_AND_BOUND_H
+
+#include <vector>
+#include <algorithm>
+
+#include "packingState.h"
+#include "lowerBounds.h"
+#include "greedyPacking.h"
+#include "searchBudget.h"
+#include "indexSort.h"
+#include "searchStats.h"
+#include "branching.h"
+
+// Branch and Bound solver for one bin packing instance. Every piece of search
+// state (items, bins, incumbent) belongs to the object, so independent
+// instances can be solved at the same time from different threads, each with
+// its own solver, and the bin capacity is a parameter of the instance.
+// The items are explored by decreasing size, each one in every open bin it
+// fits in and then in a new bin, with the symmetry rules of branching.h
+// shared with ExactSolver, and nodes are pruned with the L2 bound of the partial packing.
+// The first-fit decreasing packing is the starting incumbent, so a search
+// stopped by its budget always has a solution to return; one that runs to
+// the end has proven its packing optimal.
+class BranchAndBoundSolver {
+public:
+  BranchAndBoundSolver(const std::vector<int>& items, int capacity)
+    : BranchAndBoundSolver(items.data(), items.size(), capacity) {}
+
+  // Objets lus en place (depuis R par exemple) ; seule la copie triée est gardée
+  BranchAndBoundSolver(const int* items, int count, int capacity)
+    : n(count), capacity(capacity), state(capacity, count),
+      bounds(capacity, total_size(items, count)), lower(0), explored(0), stopped(false), stats(nullptr) {
+    // Trie les objets par taille décroissante (tri des indices)
+    IndexSorter sorter;
+    sorter.sort(items, n, input_index);
+    for (int i : input_index) sizes.push_back(items[i]);
+    lower = lower_bound_l2(sizes, capacity);
+  }
+
+  // Loads of the bins of the best solution found before the budget ran out
+  std::vector<int> solve(SearchBudget& budget) {
+    pack_first_fit(sizes.data(), n, state);
+    best_bins = state.load;
+    best_assignment = state.assignment;
+    best_num_bins = state.num_bins();
+
+    state.reset(n);
+    explored = 0;
+    stopped = false;
+    counters = SearchCounters();
+    if (best_num_bins > lower) branch_and_bound(0, 0, budget);
+    counters.nodes = explored;
+    if (stats) stats->merge(counters);
+    return best_bins;
+  }
+
+  // Counters (and trace) of the next solve() go to `stats`
+  void collect_stats(SearchStats* target) { stats = target; }
+
+  std::vector<int> solve() {
+    SearchBudget unlimited;
+    return solve(unlimited);
+  }
+
+  int num_bins() const { return best_num_bins; }
+
+  // Bin of each item of the best solution, in sorted_items() order
+  const std::vector<int>& assignment() const { return best_assignment; }
+
+  // Position in the input of each item, by decreasing size
+  const std::vector<int>& sorted_items() const { return input_index; }
+
+  int lower_bound() const { return lower; }
+
+  long long nodes() const { return explored; }
+
+  // True when the search ended before exploring the whole tree
+  bool interrupted() const { return stopped; }
+
+  // True when the packing of the last solve() is proven optimal
+  bool optimal() const { return !stopped || best_num_bins <= lower; }
+
+private:
+  static long long total_size(const int* items, int count) {
+    long long total = 0;
+    for (int k = 0; k < count; k++) total += items[k];
+    return total;
+  }
+
+  int n; // nombre d'objets
+  int capacity; // taille maximale d'un bac
+  std::vector<int> sizes; // tailles des objets, triées par ordre décroissant
+  std::vector<int> input_index; // position de chaque objet trié dans l'entrée
+  PackingState state; // remplissage des bacs et bac de chaque objet
+  NodeBound bounds; // borne inférieure des noeuds
+  std::vector<int> best_bins; // meilleure solution trouvée
+  std::vector<int> best_assignment; // bac de chaque objet dans cette solution
+  int best_num_bins; // nombre de bacs dans la meilleure solution
+  int lower; // borne L2 de l'instance
+  long long explored; // noeuds explorés
+  bool stopped; // budget épuisé
+  SearchCounters counters; // statistiques de la recherche
+  SearchStats* stats; // où les reporter
+
+  // Ajoute un objet à un bac
+  void add_item(int bin, int item) {
+    state.place(item, bin, sizes[item]);
+  }
+
+  // Supprime un objet d'un bac
+  void remove_item(int item) {
+    state.remove(item, sizes[item]);
+  }
+
+  // Recherche la meilleure solution en utilisant l'algorithme de Branch and Bound
+  void branch_and_bound(int item, int num_bins, SearchBudget& budget) {
+    if (stopped || !budget.tick(explored, true, best_num_bins, lower)) {
+      stopped = true;
+      return;
+    }
+
+    // Cas de base : tous les objets ont été affectés à un bac
+    if (item == n) {
+      // Mise à jour de la meilleure solution
+      if (num_bins < best_num_bins) {
+        best_num_bins = num_bins;
+        best_bins.assign(state.load.begin(), state.load.begin() + num_bins);
+        best_assignment = state.assignment;
+        counters.improvements++;
+        if (stats) stats->improved(explored, best_num_bins);
+      }
+      return;
+    }
+
+    // Borne inférieure (L2 sur les bacs ouverts et les objets restants)
+    int lower_bound = bounds.bound(state, sizes.data() + item, n - item);
+
+    // Élagage : ce noeud ne peut pas faire mieux que la meilleure solution
+    if (lower_bound >= best_num_bins) {
+      counters.pruned_bound++;
+      return;
+    }
+
+    // Affectation de l'objet courant à chaque bac ouvert qui peut le recevoir
+    // (voir branching.h pour les symétries écartées)
+    bool searched = branch_open_bins(state, sizes.data(), item, counters, [&](int bin) {
+      add_item(bin, item);
+      branch_and_bound(item + 1, num_bins, budget);
+      remove_item(item);
+      return !stopped;
+    });
+    if (!searched) return;
+
+    // Ajout d'un nouveau bac et affectation de l'objet courant à ce bac,
+    // s'il peut encore mener à une meilleure solution
+    if (num_bins + 1 < best_num_bins) {
+      int bin = state.open_bin();
+      add_item(bin, item);
+      branch_and_bound(item + 1, num_bins + 1, budget);
+      remove_item(item);
+      state.close_bin();
+    } else {
+      counters.pruned_incumbent++;
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef BRANCHING_H
+#define BRANCHING_H
+
+#include "packingState.h"
+#include "searchStats.h"
+
+// Branching of the exact searches, which place the items by decreasing size:
+// item `item` of `sizes` is tried in every open bin of `state` it fits in,
+// with two symmetry rules.
+//  - Copies of a size go to non-decreasing bins: a copy starts from the bin
+//    of the previous one, which rules out the permutations of the copies.
+//  - Bins with equal loads are interchangeable: only the first is tried.
+// visit(bin) explores the branch (placing the item, searching, removing it)
+// and returns false to stop; so does branch_open_bins() then. Branches
+// skipped as symmetric are counted. Opening a new bin, the last branch, is
+// left to the caller, whose bound on it differs from one search to another.
+template <typename Visit>
+bool branch_open_bins(const PackingState& state, const int* sizes, int item,
+                      SearchCounters& counters, Visit visit) {
+  int size = sizes[item];
+  int first = item > 0 && sizes[item - 1] == size ? state.assignment[item - 1] : 0;
+  int bins = state.num_bins();
+  for (int bin = first; bin < bins; bin++) {
+    if (!state.fits(bin, size)) continue;
+    bool seen = false;
+    for (int other = first; other < bin && !seen; other++) {
+      seen = state.load[other] == state.load[bin];
+    }
+    if (seen) {
+      counters.pruned_symmetry++;
+      continue;
+    }
+    if (!visit(bin)) return false;
+  }
+  return true;
+}
+
+#endif
@@ -0,0 +1,132 @@
+#include <Rcpp.h>
+using namespace Rcpp;
+using namespace std;
+
+#include <vector>
+#include <thread>
+
+#include "exactSolver.h"
+#include "packingState.h"
+#include "searchBudget.h"
+#include "rInterface.h"
+
+static int worker_threads(int threads) {
+  return threads > 0 ? threads : max(1u, thread::hardware_concurrency());
+}
+
+//' Parallel branch and bound algorithm using C++
+//'
+//' Exact search for the minimal number of storages, run on a work-stealing
+//' pool of threads. Every thread prunes against the best packing found by any
+//' of them and the search stops as soon as it reaches the lower bound. See
+//' \code{exact_bin_packing_Rcpp} for the search itself.
+//' @param c an unsorted vector of games' sizes
+//' @param max_bin_size an integer corresponding to the memory size
+//' @param threads number of worker threads, 0 to use every core
+//' @param time_limit maximal running time in seconds, 0 for no limit
+//' @param max_nodes maximal number of search nodes, 0 for no limit
+//' @param progress an optional function, called about once per second with a
+//'        list (nodes, elapsed, num_bins, lower_bound) describing the search
+//' @return the loads of the storages used by the best packing found, with the
+//'         attributes \code{lower_bound}, \code{gap} (storages above the
+//'         lower bound), \code{optimal}, \code{assignment} (the storage
+//'         of every game, in input order, numbered from 1) and \code{stats}
+//'         (nodes, pruned nodes, improvements, seconds per phase and, with
+//'         \code{options(StorageOptimisation.trace = TRUE)}, the trace of the
+//'         improvements)
+//' @export
+// [[Rcpp::export]]
+IntegerVector solve_bin_packing_parallel(SEXP c, int max_bin_size, int threads = 0,
+                                         double time_limit = 0, double max_nodes = 0,
+                                         Nullable<Function> progress = R_NilValue) {
+  SearchStats stats(trace_requested());
+  IntegerInput input(c);
+  check_sizes(input.data(), input.size(), max_bin_size);
+  SearchBudget budget(time_limit, (long long) max_nodes);
+  connect_budget(budget, progress);
+
+  ExactSolver solver(input.data(), input.size(), max_bin_size);
+  solver.collect_stats(&stats);
+  stats.lap(stats.setup_seconds);
+  std::vector<int> assignment = solver.solve(worker_threads(threads), budget);
+  budget.rethrow();
+  stats.lap(stats.search_seconds);
+
+  std::vector<int> loads;
+  const std::vector<int>& sizes = solver.sorted_sizes();
+  for (int i = 0; i < (int) assignment.size(); i++) {
+    if (assignment[i] >= (int) loads.size()) loads.resize(assignment[i] + 1, 0);
+    loads[assignment[i]] += sizes[i];
+  }
+  IntegerVector result(loads.begin(), loads.end());
+  set_search_attributes(result, loads.size(), solver.lower_bound(), solver.optimal());
+  result.attr("assignment") = input_assignment(assignment, solver.sorted_items());
+  set_stats(result, stats);
+  return result;
+}
+
+//' Exact bin packing algorithm using C++
+//'
+//' Martello-Toth style exact search. A reduction first fixes the storages
+//' that provably belong to an optimal packing (a game with no room for any
+//' other, or with the largest game it can share a storage with when they
+//' fill it exactly or no third game fits). The other games are searched by
+//' decreasing size, trying every storage they fit in and a new one, with the
+//' best of first-fit and best-fit decreasing as starting packing. Storages
+//' with equal loads and games of equal size are not tried twice, and nodes
+//' are pruned with the Martello-Toth L2 bound. The search can be stopped
+//' by a time or node budget, or interrupted from R, and then returns the
+//' best packing found so far.
+//' @param c an unsorted vector of games' sizes
+//' @param max_bin_size an integer corresponding to the memory size
+//' @param threads number of worker threads, 0 to use every core
+//' @param time_limit maximal running time in seconds, 0 for no limit
+//' @param max_nodes maximal number of search nodes, 0 for no limit
+//' @param progress an optional function, called about once per second with a
+//'        list (nodes, elapsed, num_bins, lower_bound) describing the search
+//' @return a list with the storages (\code{bins}, the sizes of the games in
+//'         each one), their number, the best lower bound known (L3, or the
+//'         number of storages once proven optimal), the \code{gap} between
+//'         the two, whether the packing is proven \code{optimal}, which is
+//'         \code{FALSE} only when the budget ran out first, the number of
+//'         search nodes and the \code{assignment} of every game to a storage,
+//'         in input order and numbered from 1, with a \code{stats} attribute
+//'         (nodes, pruned nodes, improvements, seconds per phase and, with
+//'         \code{options(StorageOptimisation.trace = TRUE)}, the trace of the
+//'         improvements)
+//' @export
+// [[Rcpp::export]]
+List exact_bin_packing_Rcpp(SEXP c, int max_bin_size, int threads = 1,
+                            double time_limit = 0, double max_nodes = 0,
+                            Nullable<Function> progress = R_NilValue) {
+  SearchStats stats(trace_requested());
+  IntegerInput input(c);
+  check_sizes(input.data(), input.size(), max_bin_size);
+  SearchBudget budget(time_limit, (long long) max_nodes);
+  connect_budget(budget, progress);
+
+  ExactSolver solver(input.data(), input.size(), max_bin_size);
+  solver.collect_stats(&stats);
+  stats.lap(stats.setup_seconds);
+  std::vector<int> assignment = solver.solve(worker_threads(threads), budget);
+  budget.rethrow();
+  stats.lap(stats.search_seconds);
+
+  PackingState state(max_bin_size, assignment.size());
+  const std::vector<int>& sizes = solver.sorted_sizes();
+  for (int i = 0; i < (int) assignment.size(); i++) {
+    while (state.num_bins() <= assignment[i]) state.open_bin();
+    state.place(i, assignment[i], sizes[i]);
+  }
+
+  int lower_bound = solver.optimal() ? state.num_bins() : solver.lower_bound();
+  List result = List::create(Named("bins") = bins_list(state, sizes),
+                                    Named("num_bins") = state.num_bins(),
+                                    Named("lower_bound") = lower_bound,
+                                    Named("gap") = state.num_bins() - lower_bound,
+                                    Named("optimal") = solver.optimal(),
+                                    Named("nodes") = (double) solver.nodes(),
+                                    Named("assignment") = input_assignment(assignment, solver.sorted_items()));
+  set_stats(result, stats);
+  return result;
+}
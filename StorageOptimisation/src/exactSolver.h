@@ -0,0 +1,328 @@
+#ifndef EXACT_SOLVER_H
+#define EXACT_SOLVER_H
+
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+#include "packingState.h"
+#include "greedyPacking.h"
+#include "lowerBounds.h"
+#include "reduction.h"
+#include "workStealingPool.h"
+#include "searchBudget.h"
+#include "indexSort.h"
+#include "searchStats.h"
+#include "scratchArena.h"
+#include "branching.h"
+
+// Best packing found so far by any worker. The bin count is an atomic read
+// by every node for pruning, the assignment is only touched under the mutex
+// when a worker actually improves on it.
+struct SharedIncumbent {
+  std::atomic<int> num_bins;
+  std::mutex mutex;
+  std::vector<int> assignment;
+
+  SharedIncumbent(int num_bins, const std::vector<int>& assignment)
+    : num_bins(num_bins), assignment(assignment) {}
+
+  bool offer(int bins, const std::vector<int>& candidate) {
+    if (bins >= num_bins.load()) return false;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (bins >= num_bins.load()) return false;
+    assignment = candidate;
+    num_bins.store(bins);
+    return true;
+  }
+};
+
+// Partial packing handed to another worker: the items before `item` are
+// already placed, as recorded in `assignment`, and `load` holds the bins.
+// Its buffers come from the arena of worker `owner`, reserved once for every
+// item so that they never grow there, and go back to that worker once it has
+// been searched, whichever worker searched it.
+struct Subproblem {
+  int item;
+  int owner;
+  ScratchVector<int> load;
+  ScratchVector<int> assignment;
+};
+
+// Exact bin packing in the spirit of Martello and Toth's MTP.
+//  1. The MTRP reduction fixes the bins that provably belong to an optimal
+//     packing; only the other items are searched.
+//  2. The best of FFD and BFD (or a packing given by the caller) is the
+//     starting incumbent, and the L2 bound of the remaining items (L3
+//     overall) is the target.
+//  3. Depth-first branch and bound over the items by decreasing size: each one
+//     is tried in every open bin it fits in, then in a new bin, with the
+//     symmetry rules of branching.h. Nodes are pruned with the L2 bound of
+//     the partial packing.
+// The search runs on a work-stealing pool: whenever a worker is idle, the
+// branches of the current node are handed to the pool instead of being
+// explored locally, and all workers prune against the shared incumbent.
+// It stops once the incumbent meets the lower bound, or when the time or node
+// budget is spent, in which case the packing is not proven optimal. The
+// calling thread is worker 0 and is the one polling the budget's hooks.
+// Every worker leases an arena from the shared pool for its subproblems,
+// and gets them back once searched for reuse, so that once the pool has
+// warmed up the search does not allocate; the arenas, reset, serve the next
+// call.
+class ExactSolver {
+public:
+  ExactSolver(const std::vector<int>& items, int capacity)
+    : ExactSolver(items.data(), items.size(), capacity) {}
+
+  // Items read in place, e.g. from R; only the sorted copy is kept
+  ExactSolver(const int* items, int count, int capacity)
+    : capacity(capacity), explored(0), proven(false), shared(nullptr), stats(nullptr) {
+    IndexSorter sorter;
+    sorter.sort(items, count, input_index);
+    for (int i : input_index) sizes.push_back(items[i]);
+    Reduction reduction = reduce(sizes, capacity);
+    fixed = reduction.fixed;
+    free_items = reduction.free;
+    n = free_items.size();
+    total = 0;
+    for (int i : free_items) {
+      free_sizes.push_back(sizes[i]);
+      total += sizes[i];
+    }
+    lower = std::max<int>(lower_bound_l2(sizes, capacity),
+                          fixed.size() + lower_bound_l2(free_sizes, capacity));
+  }
+
+  // Sizes in the order used by the assignment returned by solve()
+  const std::vector<int>& sorted_sizes() const { return sizes; }
+
+  // Position in the input of each item of sorted_sizes()
+  const std::vector<int>& sorted_items() const { return input_index; }
+
+  int lower_bound() const { return lower; }
+
+  long long nodes() const { return explored; }
+
+  // True when the last solve() proved its packing optimal, or, with a shared
+  // bound, that no packing beats min(own packing, shared bound)
+  bool optimal() const { return proven; }
+
+  // Bin count of a packing found elsewhere (by another engine), read during
+  // the search: branches that cannot beat it are pruned too
+  void share_bound(const std::atomic<int>* bound) { shared = bound; }
+
+  // Counters of every worker (and the trace) of the next solve() go to `stats`
+  void collect_stats(SearchStats* target) { stats = target; }
+
+  // Packing of sorted_sizes() (bin of every item) the next solve() starts
+  // from, for callers that already hold a greedy packing, like the
+  // portfolio: when the reduction fixed no bin, it replaces FFD and BFD,
+  // which would only compute it again; otherwise its bins restricted to the
+  // searched items compete with FFD and BFD of those items.
+  void start_from(const std::vector<int>& sorted_assignment) { given_start = sorted_assignment; }
+
+  // Bin of each item (in sorted_sizes() order) in the best packing found
+  // before the budget ran out
+  std::vector<int> solve(int threads, SearchBudget& budget) {
+    explored = 0;
+
+    std::vector<int> start = initial_incumbent();
+    int start_bins = count_bins(start);
+    int target = lower - (int) fixed.size();
+
+    if (start_bins > target) {
+      SharedIncumbent incumbent(start_bins, start);
+      // workers (and their arenas) outlive the subproblems left in the pool
+      // when it is cancelled; a deque, as they hold a mutex and never move
+      std::deque<Worker> workers;
+      for (int w = 0; w < std::max(1, threads); w++) workers.emplace_back(w, capacity, n, total);
+      WorkStealingPool<Subproblem> pool((int) workers.size());
+
+      Subproblem root = workers[0].subproblem(n);
+      root.item = 0;
+      root.assignment.assign(n, -1);
+      pool.push(0, std::move(root));
+      pool.run([&](Subproblem& task, int w) {
+        Worker& worker = workers[w];
+        worker.state.reset(n);
+        for (int load : task.load) {
+          worker.state.load.push_back(load);
+          worker.state.residual.push_back(capacity - load);
+        }
+        worker.state.assignment.assign(task.assignment.begin(), task.assignment.end());
+        search(worker, task.item, target, pool, incumbent, budget);
+        workers[task.owner].recycle(std::move(task));
+      });
+
+      for (Worker& worker : workers) {
+        explored += worker.nodes;
+        worker.counters.nodes = worker.nodes;
+        if (stats) stats->merge(worker.counters);
+      }
+      start = incumbent.assignment;
+      start_bins = incumbent.num_bins.load();
+    }
+    proven = start_bins <= target || !budget.exhausted();
+
+    // fixed bins first, then the searched ones
+    std::vector<int> assignment(sizes.size(), -1);
+    for (int b = 0; b < (int) fixed.size(); b++) {
+      for (int i : fixed[b]) assignment[i] = b;
+    }
+    for (int k = 0; k < n; k++) assignment[free_items[k]] = fixed.size() + start[k];
+    return assignment;
+  }
+
+private:
+  // Do not hand out subproblems this close to the leaves
+  static const int MIN_SPLIT_ITEMS = 8;
+
+  struct Worker {
+    int id;
+    PackingState state;
+    NodeBound bounds;
+    long long nodes;
+    SearchCounters counters;
+    ArenaLease arena;
+    std::mutex mutex;                // guards spare, filled by every worker
+    std::vector<Subproblem> spare;   // searched subproblems from this arena
+    Worker(int id, int capacity, int n, long long total)
+      : id(id), state(capacity, n), bounds(capacity, total), nodes(0) {}
+
+    // Subproblem with room for n items, recycled when possible
+    Subproblem subproblem(int n) {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!spare.empty()) {
+          Subproblem task = std::move(spare.back());
+          spare.pop_back();
+          return task;
+        }
+      }
+      ArenaAllocator<int> alloc(*arena);
+      Subproblem task{0, id, ScratchVector<int>(alloc), ScratchVector<int>(alloc)};
+      task.load.reserve(n); // never more bins than items
+      task.assignment.reserve(n);
+      return task;
+    }
+
+    // Takes back a subproblem of this worker's arena
+    void recycle(Subproblem&& task) {
+      std::lock_guard<std::mutex> lock(mutex);
+      spare.push_back(std::move(task));
+    }
+  };
+
+  int capacity;
+  std::vector<int> sizes;               // whole instance, decreasing
+  std::vector<int> input_index;         // input position of each of them
+  std::vector<std::vector<int>> fixed;  // bins fixed by the reduction
+  std::vector<int> free_items;          // searched items (indices in sizes)
+  std::vector<int> free_sizes;          // their sizes, decreasing
+  int n;
+  long long total;
+  int lower;
+  long long explored;
+  bool proven;
+  const std::atomic<int>* shared;
+  SearchStats* stats;
+  std::vector<int> given_start;         // see start_from()
+
+  static int count_bins(const std::vector<int>& assignment) {
+    int bins = 0;
+    for (int bin : assignment) bins = std::max(bins, bin + 1);
+    return bins;
+  }
+
+  // Bins (among the searched ones) a branch has to beat
+  int limit(const SharedIncumbent& incumbent) const {
+    int bins = incumbent.num_bins.load(std::memory_order_relaxed);
+    if (shared) bins = std::min(bins, shared->load(std::memory_order_relaxed) - (int) fixed.size());
+    return bins;
+  }
+
+  // Bins of the searched items in a packing of the whole instance, numbered
+  // from 0 in order of appearance
+  std::vector<int> searched_part(const std::vector<int>& packing) const {
+    std::vector<int> renumber, start(n);
+    int bins = 0;
+    for (int k = 0; k < n; k++) {
+      int bin = packing[free_items[k]];
+      if (bin >= (int) renumber.size()) renumber.resize(bin + 1, -1);
+      if (renumber[bin] < 0) renumber[bin] = bins++;
+      start[k] = renumber[bin];
+    }
+    return start;
+  }
+
+  std::vector<int> initial_incumbent() {
+    std::vector<int> given;
+    given.swap(given_start);
+    if (!given.empty()) given = searched_part(given);
+    if (!given.empty() && fixed.empty()) return given;
+    std::vector<int> greedy = greedy_incumbent();
+    return given.empty() || count_bins(greedy) <= count_bins(given) ? greedy : given;
+  }
+
+  std::vector<int> greedy_incumbent() const {
+    PackingState ffd(capacity, n), bfd(capacity, n);
+    pack_first_fit(free_sizes.data(), n, ffd);
+    pack_best_fit(free_sizes.data(), n, bfd);
+    return bfd.num_bins() < ffd.num_bins() ? bfd.assignment : ffd.assignment;
+  }
+
+  void search(Worker& worker, int item, int target, WorkStealingPool<Subproblem>& pool,
+              SharedIncumbent& incumbent, SearchBudget& budget) {
+    if (pool.cancelled()) return;
+    if (!budget.tick(worker.nodes, worker.id == 0,
+                     fixed.size() + limit(incumbent), lower)) {
+      pool.cancel();
+      return;
+    }
+    PackingState& state = worker.state;
+    int bins = state.num_bins();
+
+    if (item == n) {
+      if (incumbent.offer(bins, state.assignment)) {
+        worker.counters.improvements++;
+        if (stats) stats->improved(worker.nodes, fixed.size() + bins);
+        if (bins <= target) pool.cancel();
+      }
+      return;
+    }
+    int bound = worker.bounds.bound(state, free_sizes.data() + item, n - item);
+    if (bound >= limit(incumbent)) {
+      worker.counters.pruned_bound++;
+      return;
+    }
+
+    int size = free_sizes[item];
+    bool split = n - item > MIN_SPLIT_ITEMS;
+    // searched here, or handed to an idle worker
+    auto branch = [&](int bin) {
+      state.place(item, bin, size);
+      if (split && pool.hungry()) {
+        Subproblem task = worker.subproblem(n);
+        task.item = item + 1;
+        task.load.assign(state.load.begin(), state.load.end());
+        task.assignment.assign(state.assignment.begin(), state.assignment.end());
+        pool.push(worker.id, std::move(task));
+      } else {
+        search(worker, item + 1, target, pool, incumbent, budget);
+      }
+      state.remove(item, size);
+      return !pool.cancelled();
+    };
+    if (!branch_open_bins(state, free_sizes.data(), item, worker.counters, branch)) return;
+    if (bins + 1 >= limit(incumbent)) {
+      worker.counters.pruned_incumbent++;
+      return;
+    }
+    branch(state.open_bin());
+    state.close_bin();
+  }
+};
+
+#endif
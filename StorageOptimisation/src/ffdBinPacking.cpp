@@ -7,33 +7,78 @@ using namespace std;
 #include <algorithm>
 #include <numeric>
 
+#include "packingState.h"
+#include "greedyPacking.h"
+#include "rInterface.h"
+
 //' First-fit-decreasing bin packing algorithm
-//' @param items A vector containing the sizes of items to be packed.
-//' @param bin_size The maximum capacity of each bin.
+//' @param games A vector containing the sizes of items to be packed.
+//' @param storage The maximum capacity of each bin.
 //' @return A vector of vectors representing the bins, where each inner vector
-//'         contains the sizes of items packed into a single bin.
+//'         contains the sizes of items packed into a single bin, with an
+//'         \code{assignment} attribute giving the bin of every item, in
+//'         input order, numbered from 1, and a \code{stats} attribute
+//'         timing its phases.
 //' @export
 // [[Rcpp::export]] //mandatory to export the function
-std::vector<std::vector<int>> ffd_bin_packing_Rcpp(std::vector<int>& games, int storage)
+List ffd_bin_packing_Rcpp(SEXP games, int storage)
   {
-    sort(games.begin(), games.end(), greater<int>());
-
-    vector<vector<int>> bins;
-
-    for (int game : games) {
-        bool fitted = false;
-        for (vector<int>& bin : bins) {
-            if (accumulate(bin.begin(), bin.end(), 0) + game <= storage) {
-                bin.push_back(game);
-                fitted = true;
-                break;
-            }
-        }
+    SearchStats stats;
+    // Only the indices are sorted, the input keeps its order
+    SortedInput input(games, storage);
+    const std::vector<int>& sizes = input.sizes;
+    stats.lap(stats.setup_seconds);
+
+    PackingState state(storage, sizes.size());
 
-        if (!fitted) {
-            bins.push_back({game});
+    for (int i = 0; i < (int) sizes.size(); i++) {
+        // The scan is quadratic on large inputs, let the user interrupt it
+        if (i % 1024 == 0) checkUserInterrupt();
+        int game = sizes[i];
+        int bin = 0;
+        while (bin < state.num_bins() && !state.fits(bin, game)) bin++;
+
+        if (bin == state.num_bins()) {
+            state.open_bin();
         }
+        state.place(i, bin, game);
     }
+    stats.lap(stats.search_seconds);
+
+    List bins = bins_list(state, sizes);
+    bins.attr("assignment") = input_assignment(state.assignment, input.input_index);
+    set_stats(bins, stats);
+    return bins;
+}
+
+
+
+//' First-fit-decreasing bin packing algorithm using a segment tree
+//'
+//' Same packing as \code{ffd_bin_packing_Rcpp}, but the first bin able to
+//' take each game is found in O(log n) with a max segment tree over the bins'
+//' residual capacities, instead of rescanning and summing every open bin.
+//' @param games A vector containing the sizes of items to be packed.
+//' @param storage The maximum capacity of each bin.
+//' @return A list of vectors representing the bins, where each inner vector
+//'         contains the sizes of items packed into a single bin, with an
+//'         \code{assignment} attribute giving the bin of every item, in
+//'         input order, numbered from 1, and a \code{stats} attribute
+//'         timing its phases.
+//' @export
+// [[Rcpp::export]]
+List ffd_tree_Rcpp(SEXP games, int storage)
+{
+    SearchStats stats;
+    SortedInput input(games, storage);
+    stats.lap(stats.setup_seconds);
+
+    PackingState state(storage, input.sizes.size());
+    pack_first_fit(input.sizes.data(), input.sizes.size(), state);
+    stats.lap(stats.search_seconds);
 
+    List bins = bins_list(state, input.sizes);
+    bins.attr("assignment") = input_assignment(state.assignment, input.input_index);
+    set_stats(bins, stats);
     return bins;
-}
\ No newline at end of file
+}
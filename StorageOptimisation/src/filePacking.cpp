@@ -0,0 +1,66 @@
+#include <Rcpp.h>
+using namespace Rcpp;
+using namespace std;
+
+#include <string>
+
+#include "filePacking.h"
+#include "rInterface.h"
+
+static FileSizeType parse_type(const std::string& type) {
+  if (type == "int32") return FILE_INT32;
+  if (type == "int64") return FILE_INT64;
+  stop("unknown size type '%s', use \"int32\" or \"int64\"", type);
+}
+
+//' Out-of-core bin packing of a file of sizes using C++
+//'
+//' Packs the games of a binary file with first-fit or best-fit decreasing,
+//' for inventories too large to be loaded in R. The file holds one size per
+//' game, as native int32 or int64 values; it is mapped in memory and read
+//' twice, once to count the games of every size, which are then packed by
+//' size class, and once to write the storage of every game, in input order
+//' and numbered from 1, as int32 values to \code{output}. The pages of both
+//' files are released as they are done with, so the memory used depends on
+//' the number of distinct sizes and of storages, not on the number of games.
+//' The storages and their loads are the ones \code{pack_flat_Rcpp} gives for
+//' the same games.
+//' @param input path of the file of sizes
+//' @param output path of the file of storages, created or overwritten; it
+//'        must not be the input file
+//' @param storage the storage size
+//' @param type \code{"int32"} or \code{"int64"}, the type of the sizes
+//' @param algorithm \code{"ffd"} (first-fit decreasing) or \code{"bfd"}
+//'        (best-fit decreasing)
+//' @return a list with the number of games (\code{num_items}), of storages
+//'         (\code{num_bins}), the \code{loads} of the storages, the L2
+//'         \code{lower_bound}, the \code{gap} between the two and the
+//'         \code{output} path, with a \code{stats} attribute giving the
+//'         seconds spent counting the sizes (setup) and packing and writing
+//'         the storages (search)
+//' @export
+// [[Rcpp::export(rng = false)]]
+List pack_file_Rcpp(std::string input, std::string output, int storage,
+                    std::string type = "int32", std::string algorithm = "ffd") {
+  if (algorithm != "ffd" && algorithm != "bfd") {
+    stop("unknown algorithm '%s', use \"ffd\" or \"bfd\"", algorithm);
+  }
+  SearchStats stats;
+  FilePacker packer(input, parse_type(type), storage);
+  packer.count_classes();
+  stats.lap(stats.setup_seconds);
+
+  packer.pack(algorithm == "bfd");
+  packer.write_assignment(output);
+  stats.lap(stats.search_seconds);
+
+  int lower_bound = packer.lower_bound();
+  List result = List::create(Named("num_items") = (double) packer.num_items(),
+                             Named("num_bins") = packer.num_bins(),
+                             Named("loads") = packer.bin_loads(),
+                             Named("lower_bound") = lower_bound,
+                             Named("gap") = packer.num_bins() - lower_bound,
+                             Named("output") = output);
+  set_stats(result, stats);
+  return result;
+}
@@ -0,0 +1,217 @@
+#ifndef FILE_PACKING_H
+#define FILE_PACKING_H
+
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <climits>
+#include <algorithm>
+#include <unordered_map>
+#include <stdexcept>
+
+#include "mappedFile.h"
+#include "greedyPacking.h"
+#include "lowerBounds.h"
+
+// Out-of-core FFD / BFD for inputs larger than the RAM. The sizes are read
+// from a binary file of native int32 or int64 values, mapped in memory, and
+// the bin of every item (int32, numbered from 1, in input order) is written
+// to a mapped output file. Three passes:
+//  1. the input is streamed once to count the copies of every size (a
+//     counting sort into size classes);
+//  2. the classes, by decreasing size, are packed as runs by the code and
+//     kernels of greedyPacking.h: each placement puts as many copies of a
+//     size in a bin as fit, and is recorded as a (bin, copies) run of its
+//     class;
+//  3. the input is streamed again: the k-th item of a size in input order
+//     takes the k-th slot of its class' runs, so the packing is the one FFD /
+//     BFD gives on the sorted items.
+// Both files are walked window by window and the pages of a window are
+// given back once it is done, so the resident memory holds one window of
+// each file plus O(distinct sizes + bins + runs), whatever the number of
+// items; a run being a (size, bin) pair of the packing, there are at most
+// bins * (items per bin) of them and usually far fewer.
+
+enum FileSizeType { FILE_INT32, FILE_INT64 };
+
+const std::size_t FILE_WINDOW = (std::size_t) 1 << 26; // bytes streamed between releases
+const int DENSE_CLASSES = 1 << 20; // capacities up to this count sizes in an array
+
+// Copies of a size put in one bin
+struct ClassRun {
+  int bin;
+  long long count;
+};
+
+class FilePacker {
+public:
+  FilePacker(const std::string& input, FileSizeType type, int capacity)
+    : in(input), type(type), width(type == FILE_INT32 ? 4 : 8), capacity(capacity) {
+    if (capacity <= 0) throw std::invalid_argument("the storage size must be positive");
+    if (in.size() % width != 0) {
+      throw std::runtime_error("the size of '" + input + "' is not a multiple of " +
+                               std::to_string(width) + " bytes");
+    }
+    items = in.size() / width;
+    in.sequential();
+  }
+
+  long long num_items() const { return items; }
+
+  int num_bins() const { return (int) loads.size(); }
+
+  const std::vector<int>& bin_loads() const { return loads; }
+
+  // Distinct sizes, by decreasing size, once counted
+  const std::vector<SizeClass>& size_classes() const { return classes; }
+
+  // Pass 1: sizes out of [0, capacity] are rejected
+  void count_classes() {
+    classes.clear();
+    if (capacity <= DENSE_CLASSES) {
+      std::vector<long long> count(capacity + 1, 0);
+      stream([&](long long, int size) { count[size]++; });
+      for (int size = capacity; size >= 0; size--) {
+        if (count[size] > 0) classes.push_back(SizeClass{size, count[size]});
+      }
+    } else {
+      std::unordered_map<int, long long> count;
+      stream([&](long long, int size) { count[size]++; });
+      for (const auto& entry : count) classes.push_back(SizeClass{entry.first, entry.second});
+      std::sort(classes.begin(), classes.end(),
+                [](const SizeClass& a, const SizeClass& b) { return a.size > b.size; });
+    }
+  }
+
+  // Pass 2: first fit or best fit over the classes
+  void pack(bool best_fit) {
+    loads.clear();
+    runs.clear();
+    RunBins bins{capacity, loads, runs};
+    GreedyKernels kernels;
+    pack_classes(classes.data(), (int) classes.size(), bins, best_fit, kernels);
+    // the runs of a class follow each other, its copies in total
+    first_run.assign(1, 0);
+    std::size_t r = 0;
+    for (const SizeClass& c : classes) {
+      for (long long left = c.count; left > 0; r++) left -= runs[r].count;
+      first_run.push_back(r);
+    }
+  }
+
+  // Pass 3: writes the bin of every item, from 1, to a new file, which must
+  // not be the input (creating it would truncate the mapped input)
+  void write_assignment(const std::string& output) {
+    if (in.same_file(output)) {
+      throw std::invalid_argument("the output file must not be the input file");
+    }
+    MappedFile out(output, (std::size_t) items * sizeof(int32_t));
+    std::vector<std::size_t> run(classes.size());      // current run of every class
+    std::vector<long long> used(classes.size(), 0);     // its slots taken
+    for (std::size_t c = 0; c < classes.size(); c++) run[c] = first_run[c];
+
+    std::vector<int> dense;
+    std::unordered_map<int, int> sparse;
+    if (capacity <= DENSE_CLASSES) dense.assign(capacity + 1, -1);
+    for (std::size_t c = 0; c < classes.size(); c++) {
+      if (capacity <= DENSE_CLASSES) dense[classes[c].size] = c;
+      else sparse[classes[c].size] = c;
+    }
+
+    char* bins = out.data();
+    std::size_t released = 0;
+    stream([&](long long i, int size) {
+      int c = capacity <= DENSE_CLASSES ? dense[size] : sparse[size];
+      if (used[c] == runs[run[c]].count) {
+        run[c]++;
+        used[c] = 0;
+      }
+      used[c]++;
+      int32_t bin = runs[run[c]].bin + 1;
+      std::memcpy(bins + i * sizeof(int32_t), &bin, sizeof bin);
+      std::size_t written = (std::size_t) (i + 1) * sizeof(int32_t);
+      if (written - released >= FILE_WINDOW) {
+        out.release(released, written - released);
+        released = written;
+      }
+    });
+  }
+
+  // Martello-Toth L2 over the size classes (see lowerBounds.h)
+  int lower_bound() const {
+    int k = classes.size();
+    std::vector<long long> items_before(k + 1, 0), volume_before(k + 1, 0);
+    for (int c = 0; c < k; c++) {
+      items_before[c + 1] = items_before[c] + classes[c].count;
+      volume_before[c + 1] = volume_before[c] + classes[c].count * classes[c].size;
+    }
+    return (int) l2_sweep(k, capacity, [this](int c) { return classes[c].size; },
+                          [&items_before](int c) { return items_before[c]; }, volume_before);
+  }
+
+private:
+  // Bins of pass 2 for pack_classes(): the copies placed are recorded as
+  // runs. Bins are numbered as int32 in the output, so there can be at most
+  // INT_MAX of them.
+  struct RunBins {
+    int bin_capacity;
+    std::vector<int>& loads;
+    std::vector<ClassRun>& runs;
+
+    int capacity() const { return bin_capacity; }
+    int residual(int bin) const { return bin_capacity - loads[bin]; }
+    int open_bin() {
+      if (loads.size() >= (std::size_t) INT_MAX) {
+        throw std::runtime_error("the games need more than " + std::to_string(INT_MAX) + " storages");
+      }
+      loads.push_back(0);
+      return (int) (loads.size() - 1);
+    }
+    void place(int bin, long long copies, int size) {
+      loads[bin] += (int) (copies * size);
+      runs.push_back(ClassRun{bin, copies});
+    }
+  };
+
+  MappedFile in;
+  FileSizeType type;
+  std::size_t width;
+  int capacity;
+  long long items;
+  std::vector<SizeClass> classes;
+  std::vector<int> loads;
+  std::vector<ClassRun> runs;
+  std::vector<std::size_t> first_run; // runs of class c: first_run[c] .. first_run[c + 1] - 1
+
+  // Calls visit(i, size) on every item in input order, giving back the pages
+  // of the input window by window
+  template <typename Visit>
+  void stream(Visit visit) {
+    const char* data = in.data();
+    std::size_t per_window = FILE_WINDOW / width;
+    for (long long start = 0; start < items; start += per_window) {
+      long long end = std::min<long long>(items, start + per_window);
+      for (long long i = start; i < end; i++) {
+        long long size;
+        if (type == FILE_INT32) {
+          int32_t value;
+          std::memcpy(&value, data + i * width, sizeof value);
+          size = value;
+        } else {
+          int64_t value;
+          std::memcpy(&value, data + i * width, sizeof value);
+          size = value;
+        }
+        if (size < 0 || size > capacity) {
+          throw std::runtime_error("item " + std::to_string(i + 1) +
+                                   " does not fit in an empty storage");
+        }
+        visit(i, (int) size);
+      }
+      in.release(start * width, (end - start) * width);
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,183 @@
+#ifndef GREEDY_PACKING_H
+#define GREEDY_PACKING_H
+
+#include <algorithm>
+#include <cstdint>
+
+#include "packingState.h"
+#include "residualTree.h"
+#include "residualSet.h"
+#include "residualKernels.h"
+
+// Greedy packers shared by the exported heuristics and by the exact solvers,
+// which use them as starting incumbents. Items are packed in the order given
+// (callers sort them by decreasing size for FFD / BFD); `state` is reset.
+// The overloads taking the search structures let callers packing many
+// instances reuse them.
+//
+// Consecutive items of the same size (the size classes of a sorted input)
+// are placed as a run: the copies go to the bin the first one would go to,
+// as many as fit (floor(residual / size)), then to the next bin chosen the
+// same way. It is the packing item by item would give, since a bin that
+// took a copy stays the first / tightest bin able to take the next one, but
+// a run costs one search per bin it touches, so inputs with many duplicate
+// sizes are packed in O(n + bins log bins).
+
+// Number of items starting at `first` that have the same size
+inline int run_length(const int* sizes, int n, int first) {
+  int end = first + 1;
+  while (end < n && sizes[end] == sizes[first]) end++;
+  return end - first;
+}
+
+// Copies of `size` a bin with this residual takes out of `left`; size 0
+// items all go to the first bin
+inline long long run_fit(int residual, int size, long long left) {
+  return size > 0 ? std::max(1LL, std::min<long long>(left, residual / size)) : left;
+}
+
+// Size class of a sorted input: `count` copies of `size`
+struct SizeClass {
+  int size;
+  long long count;
+};
+
+// The copies of a run are placed through `Bins`, which holds the bins: it has
+// capacity(), residual(bin), open_bin() and place(bin, copies, size). The
+// items in memory are packed into a PackingState (StateBins below); the
+// out-of-core packer of filePacking.h records the runs instead.
+
+// First fit: leftmost open bin with enough room, O(log n) per bin touched.
+// `Residuals` is ResidualTree or one of the BlockResiduals kernels.
+template <typename Residuals, typename Bins>
+void first_fit_copies(int size, long long copies, Bins& bins, Residuals& residuals) {
+  while (copies > 0) {
+    int bin = residuals.first_fit(size);
+    if (bin < 0) {
+      bin = bins.open_bin();
+      residuals.open_bin(bins.capacity());
+    }
+    long long count = run_fit(bins.residual(bin), size, copies);
+    bins.place(bin, count, size);
+    residuals.set_residual(bin, bins.residual(bin));
+    copies -= count;
+  }
+}
+
+// Best fit: fullest open bin with enough room, O(log n) per bin touched.
+// `Residuals` is ResidualSet or ResidualBuckets.
+template <typename Residuals, typename Bins>
+void best_fit_copies(int size, long long copies, Bins& bins, Residuals& residuals) {
+  while (copies > 0) {
+    int bin = residuals.best_fit(size);
+    if (bin < 0) {
+      bin = bins.open_bin();
+      residuals.add_bin(bin, bins.residual(bin));
+    }
+    long long count = run_fit(bins.residual(bin), size, copies);
+    residuals.update(bin, bins.residual(bin), bins.residual(bin) - (int) (count * size));
+    bins.place(bin, count, size);
+    copies -= count;
+  }
+}
+
+// Items in memory, placed in order into a PackingState
+struct StateBins {
+  PackingState& state;
+  int next; // first item not placed yet
+
+  int capacity() const { return state.capacity; }
+  int residual(int bin) const { return state.residual[bin]; }
+  int open_bin() { return state.open_bin(); }
+  void place(int bin, long long copies, int size) {
+    state.place_run(next, (int) copies, bin, size);
+    next += (int) copies;
+  }
+};
+
+template <typename Residuals>
+void first_fit_runs(const int* sizes, int n, PackingState& state, Residuals& residuals) {
+  state.reset(n);
+  residuals.reset(n);
+  StateBins bins{state, 0};
+  for (int i = 0; i < n;) {
+    int run = run_length(sizes, n, i);
+    first_fit_copies(sizes[i], run, bins, residuals);
+    i += run;
+  }
+}
+
+// `residuals` already emptied
+template <typename Residuals>
+void best_fit_runs(const int* sizes, int n, PackingState& state, Residuals& residuals) {
+  state.reset(n);
+  StateBins bins{state, 0};
+  for (int i = 0; i < n;) {
+    int run = run_length(sizes, n, i);
+    best_fit_copies(sizes[i], run, bins, residuals);
+    i += run;
+  }
+}
+
+// Search structures of every kernel, chosen from the capacity: residuals up
+// to NARROW_CAPACITY are kept as uint8_t and up to MEDIUM_CAPACITY as
+// uint16_t (bucketed by value for best fit), larger ones as int. Callers
+// packing many instances keep one and reuse it.
+struct GreedyKernels {
+  BlockResiduals<uint8_t> narrow;
+  BlockResiduals<uint16_t> medium;
+  ResidualTree wide;
+  ResidualBuckets buckets;
+  ResidualSet set;
+};
+
+inline void pack_first_fit(const int* sizes, int n, PackingState& state, GreedyKernels& kernels) {
+  if (state.capacity <= NARROW_CAPACITY) first_fit_runs(sizes, n, state, kernels.narrow);
+  else if (state.capacity <= MEDIUM_CAPACITY) first_fit_runs(sizes, n, state, kernels.medium);
+  else first_fit_runs(sizes, n, state, kernels.wide);
+}
+
+inline void pack_first_fit(const int* sizes, int n, PackingState& state) {
+  GreedyKernels kernels;
+  pack_first_fit(sizes, n, state, kernels);
+}
+
+inline void pack_best_fit(const int* sizes, int n, PackingState& state, GreedyKernels& kernels) {
+  if (state.capacity <= MEDIUM_CAPACITY) {
+    kernels.buckets.reset(state.capacity);
+    best_fit_runs(sizes, n, state, kernels.buckets);
+  } else {
+    kernels.set.clear();
+    best_fit_runs(sizes, n, state, kernels.set);
+  }
+}
+
+inline void pack_best_fit(const int* sizes, int n, PackingState& state) {
+  GreedyKernels kernels;
+  pack_best_fit(sizes, n, state, kernels);
+}
+
+// FFD / BFD over size classes given by decreasing size, with the kernel of
+// the capacity, for inputs only known by their classes
+template <typename Bins>
+void pack_classes(const SizeClass* classes, int k, Bins& bins, bool best_fit, GreedyKernels& kernels) {
+  int capacity = bins.capacity();
+  if (best_fit && capacity <= MEDIUM_CAPACITY) {
+    kernels.buckets.reset(capacity);
+    for (int c = 0; c < k; c++) best_fit_copies(classes[c].size, classes[c].count, bins, kernels.buckets);
+  } else if (best_fit) {
+    kernels.set.clear();
+    for (int c = 0; c < k; c++) best_fit_copies(classes[c].size, classes[c].count, bins, kernels.set);
+  } else if (capacity <= NARROW_CAPACITY) {
+    kernels.narrow.reset(1);
+    for (int c = 0; c < k; c++) first_fit_copies(classes[c].size, classes[c].count, bins, kernels.narrow);
+  } else if (capacity <= MEDIUM_CAPACITY) {
+    kernels.medium.reset(1);
+    for (int c = 0; c < k; c++) first_fit_copies(classes[c].size, classes[c].count, bins, kernels.medium);
+  } else {
+    kernels.wide.reset(1);
+    for (int c = 0; c < k; c++) first_fit_copies(classes[c].size, classes[c].count, bins, kernels.wide);
+  }
+}
+
+#endif
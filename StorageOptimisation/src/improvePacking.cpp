@@ -0,0 +1,80 @@
+#include <Rcpp.h>
+using namespace Rcpp;
+using namespace std;
+
+#include <vector>
+
+#include "localSearch.h"
+#include "lowerBounds.h"
+#include "searchBudget.h"
+#include "rInterface.h"
+
+//' Local search improvement of a packing using C++
+//'
+//' Tries to eliminate storages from any packing, e.g. the one of
+//' \code{ffd_bin_packing_Rcpp}. One of the least loaded storages is emptied,
+//' and its games are moved into the other storages, directly or by swapping
+//' them with one or two smaller games, which then have to be moved in turn.
+//' When no storage can be emptied, random swaps between storages reshape the
+//' packing before trying again. The search stops at the L2 lower bound, when
+//' the time limit is reached, or after 100 such rounds without success.
+//' @param games a vector of games' sizes
+//' @param storage the storage size
+//' @param assignment the storage of every game, numbered from 1
+//' @param time_limit maximal running time in seconds, 0 for no limit
+//' @param seed seed of the random choices; a seed always gives the same
+//'        packing
+//' @param progress an optional function, called about once per second with a
+//'        list (nodes, elapsed, num_bins, lower_bound) describing the search
+//' @return a list of vectors representing the storages, where each one
+//'         contains the sizes of its games, in input order, with the
+//'         attributes \code{assignment} (the storage of every game, numbered
+//'         from 1), \code{lower_bound}, \code{gap}, \code{optimal} and
+//'         \code{stats} (moves as nodes, failed attempts as bound prunings,
+//'         storages eliminated as improvements, seconds per phase and, with
+//'         \code{options(StorageOptimisation.trace = TRUE)}, the trace of the
+//'         eliminations)
+//' @export
+// [[Rcpp::export]]
+List improve_packing_Rcpp(SEXP games, int storage, IntegerVector assignment,
+                          double time_limit = 1, int seed = 1,
+                          Nullable<Function> progress = R_NilValue) {
+  SearchStats stats(trace_requested());
+  IntegerInput input(games);
+  SortedInput sorted(input, storage);
+  int n = input.size();
+  if (assignment.size() != n) {
+    stop("assignment must give the storage of every game");
+  }
+  std::vector<int> bin(n);
+  std::vector<long long> load(n, 0);
+  for (int i = 0; i < n; i++) {
+    if (assignment[i] < 1 || assignment[i] > n) {
+      stop("game %d is not in a storage numbered from 1 to %d", i + 1, n);
+    }
+    bin[i] = assignment[i] - 1;
+    load[bin[i]] += input[i];
+    if (load[bin[i]] > storage) stop("storage %d is overfilled", bin[i] + 1);
+  }
+
+  SearchBudget budget(time_limit);
+  connect_budget(budget, progress);
+  int lower = lower_bound_l2(sorted.sizes, storage);
+
+  LocalSearch search(input.data(), n, storage, bin.data(), seed);
+  search.collect_stats(&stats);
+  stats.lap(stats.setup_seconds);
+  int num_bins = search.improve(lower, budget);
+  budget.rethrow();
+  stats.lap(stats.search_seconds);
+
+  IntegerVector improved(n);
+  std::vector<int> result = search.assignment();
+  for (int i = 0; i < n; i++) improved[i] = result[i] + 1;
+
+  List bins = bins_list(input.data(), improved.begin(), n, num_bins, 1);
+  bins.attr("assignment") = improved;
+  set_search_attributes(bins, num_bins, lower, num_bins <= lower);
+  set_stats(bins, stats);
+  return bins;
+}
@@ -0,0 +1,79 @@
+#ifndef INDEX_SORT_H
+#define INDEX_SORT_H
+
+#include <vector>
+#include <algorithm>
+
+// Sorts item indices by decreasing size, ties by increasing index, instead of
+// sorting the sizes themselves: engines pack the sorted order and still know
+// which input item went where. Sizes are non-negative ints, so:
+//  - small inputs use a comparison sort,
+//  - sizes bounded by a few times n use a counting sort, O(n + max size),
+//  - anything else an LSD radix sort on two 16-bit digits, O(n).
+// Both linear sorts are stable, which gives the tie order for free. The
+// buffers are kept between calls.
+class IndexSorter {
+public:
+  void sort(const int* sizes, int n, std::vector<int>& order) {
+    order.resize(n);
+    if (n <= SMALL_SORT) {
+      for (int i = 0; i < n; i++) order[i] = i;
+      std::sort(order.begin(), order.end(), [sizes](int a, int b) {
+        return sizes[a] != sizes[b] ? sizes[a] > sizes[b] : a < b;
+      });
+      return;
+    }
+
+    int largest = 0;
+    for (int i = 0; i < n; i++) largest = std::max(largest, sizes[i]);
+    if (largest <= (long long) COUNTING_FACTOR * n) {
+      counting_sort(sizes, n, largest, order);
+    } else {
+      radix_sort(sizes, n, largest, order);
+    }
+  }
+
+private:
+  static const int SMALL_SORT = 64;
+  static const int COUNTING_FACTOR = 4;
+  static const int DIGIT_BITS = 16;
+  static const int DIGITS = 1 << DIGIT_BITS;
+
+  std::vector<int> count;
+  std::vector<int> buffer;
+
+  void counting_sort(const int* sizes, int n, int largest, std::vector<int>& order) {
+    count.assign(largest + 1, 0);
+    for (int i = 0; i < n; i++) count[sizes[i]]++;
+    // start of each size, largest first
+    int start = 0;
+    for (int s = largest; s >= 0; s--) {
+      int c = count[s];
+      count[s] = start;
+      start += c;
+    }
+    for (int i = 0; i < n; i++) order[count[sizes[i]]++] = i;
+  }
+
+  // Keys are largest - size, so increasing keys are decreasing sizes
+  void radix_sort(const int* sizes, int n, int largest, std::vector<int>& order) {
+    buffer.resize(n);
+    for (int i = 0; i < n; i++) buffer[i] = i;
+    for (int shift = 0; shift < 32; shift += DIGIT_BITS) {
+      if ((largest >> shift) == 0) break;
+      count.assign(DIGITS + 1, 0);
+      for (int k = 0; k < n; k++) {
+        count[(((unsigned) (largest - sizes[buffer[k]])) >> shift & (DIGITS - 1)) + 1]++;
+      }
+      for (int d = 0; d < DIGITS; d++) count[d + 1] += count[d];
+      for (int k = 0; k < n; k++) {
+        int i = buffer[k];
+        order[count[((unsigned) (largest - sizes[i])) >> shift & (DIGITS - 1)]++] = i;
+      }
+      buffer.swap(order);
+    }
+    buffer.swap(order);
+  }
+};
+
+#endif
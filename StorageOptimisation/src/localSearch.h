@@ -0,0 +1,293 @@
+#ifndef LOCAL_SEARCH_H
+#define LOCAL_SEARCH_H
+
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <utility>
+
+#include "searchBudget.h"
+#include "searchStats.h"
+
+// Improvement phase for any packing, in the spirit of Fleszar and Hindi's
+// bin elimination. One of the least loaded bins is emptied and its items
+// become free; each free item, largest first, is then
+//  - shifted into the fullest bin with room for it, or
+//  - swapped with one or two smaller items of a bin (1-1, 1-2), or, with a
+//    second free item, against one smaller item (2-1),
+// the swap filling that bin as much as possible and freeing the smaller
+// items instead. Every move lowers the free volume, so an attempt ends,
+// either with no free item left (the bin is gone) or with no move possible,
+// in which case it is undone from its move log.
+// When no candidate bin can be emptied, a kick of random feasible swaps
+// between bins reshapes the loads without adding a bin. The search stops at
+// the lower bound, when the budget is spent, or after MAX_KICKS kicks in a
+// row with no bin eliminated. The random choices only depend on the seed.
+// Loads and the position of every item in its bin are updated with each
+// move, so a move costs O(1) once chosen. Bin lists, free items and the move
+// log are buffers kept from one attempt to the next: the search only
+// allocates while they grow.
+class LocalSearch {
+public:
+  static const int CANDIDATES = 8; // least loaded bins tried in a round
+  static const int MAX_KICKS = 100;
+
+  // `assignment` gives the bin of every item, numbered from 0, possibly with
+  // gaps; sizes must be at most the capacity and the packing feasible
+  LocalSearch(const int* sizes, int n, int capacity, const int* assignment, unsigned seed)
+    : sizes(sizes), n(n), capacity(capacity), bin_of(n), position(n), rng(seed),
+      explored(0), polls(true), stats(nullptr) {
+    std::vector<int> renumber;
+    for (int i = 0; i < n; i++) {
+      int b = assignment[i];
+      if (b >= (int) renumber.size()) renumber.resize(b + 1, -1);
+      if (renumber[b] < 0) {
+        renumber[b] = members.size();
+        members.emplace_back();
+        load.push_back(0);
+      }
+      attach(i, renumber[b]);
+    }
+    open = members.size();
+    closed.assign(members.size(), false);
+  }
+
+  // Eliminates bins until the packing has lower_bound bins or the search
+  // gives up; returns the number of bins. The budget's hooks are only polled
+  // when running on the caller's thread.
+  int improve(int lower_bound, SearchBudget& budget, bool caller_thread = true) {
+    polls = caller_thread;
+    counters = SearchCounters();
+    int kicks = 0;
+    while (open > lower_bound && kicks < MAX_KICKS && !budget.exhausted()) {
+      bool eliminated = false;
+      int count = candidates();
+      for (int c = 0; c < count; c++) {
+        if (eliminate(open_bins[c], lower_bound, budget)) {
+          eliminated = true;
+          break;
+        }
+        if (budget.exhausted()) break;
+      }
+      if (eliminated) {
+        kicks = 0;
+      } else {
+        kicks++;
+        kick();
+      }
+    }
+    counters.nodes = explored;
+    if (stats) stats->merge(counters);
+    return open;
+  }
+
+  // Counters (and trace) of the next improve() go to `stats`: nodes are
+  // moves, improvements eliminated bins and pruned_bound failed attempts
+  void collect_stats(SearchStats* target) { stats = target; }
+
+  int num_bins() const { return open; }
+
+  long long nodes() const { return explored; }
+
+  // Bin of every item, numbered from 0 without gaps, in the order of the
+  // bins of the starting packing
+  std::vector<int> assignment() const {
+    std::vector<int> renumber(members.size(), -1);
+    int next = 0;
+    for (int b = 0; b < (int) members.size(); b++) {
+      if (!closed[b]) renumber[b] = next++;
+    }
+    std::vector<int> out(n);
+    for (int i = 0; i < n; i++) out[i] = renumber[bin_of[i]];
+    return out;
+  }
+
+private:
+  const int* sizes;
+  int n;
+  int capacity;
+  std::vector<int> bin_of;                // bin of every item, -1 when free
+  std::vector<int> position;              // index of every item in its bin
+  std::vector<std::vector<int>> members;  // items of every bin
+  std::vector<int> load;
+  std::vector<bool> closed;               // eliminated bins
+  int open;
+  std::mt19937 rng;
+  long long explored;
+  bool polls;
+  SearchCounters counters;
+  SearchStats* stats;
+  std::vector<std::pair<int, int>> undo;  // (item, bin it left), in move order
+  std::vector<int> open_bins;             // scratch list of the open bins
+  std::vector<int> free_items;            // items of the bin being emptied
+
+  void attach(int item, int bin) {
+    bin_of[item] = bin;
+    position[item] = members[bin].size();
+    members[bin].push_back(item);
+    load[bin] += sizes[item];
+  }
+
+  void detach(int item) {
+    int bin = bin_of[item];
+    std::vector<int>& m = members[bin];
+    int last = m.back();
+    m[position[item]] = last;
+    position[last] = position[item];
+    m.pop_back();
+    load[bin] -= sizes[item];
+    bin_of[item] = -1;
+    undo.push_back(std::make_pair(item, bin));
+  }
+
+  void list_open_bins() {
+    open_bins.clear();
+    for (int b = 0; b < (int) members.size(); b++) {
+      if (!closed[b]) open_bins.push_back(b);
+    }
+  }
+
+  // Puts the least loaded open bins, ties broken at random, at the front of
+  // open_bins and returns how many
+  int candidates() {
+    list_open_bins();
+    std::shuffle(open_bins.begin(), open_bins.end(), rng);
+    int count = open_bins.size();
+    if (count > CANDIDATES) count = CANDIDATES;
+    std::partial_sort(open_bins.begin(), open_bins.begin() + count, open_bins.end(),
+                      [&](int a, int b) { return load[a] < load[b]; });
+    return count;
+  }
+
+  // Puts the items moved since the start of the attempt back in their bins
+  void rollback() {
+    for (int item : free_items) bin_of[item] = -2; // marks the free items
+    for (int k = undo.size() - 1; k >= 0; k--) {
+      int item = undo[k].first;
+      if (bin_of[item] >= 0) {
+        int bin = bin_of[item];
+        std::vector<int>& m = members[bin];
+        int last = m.back();
+        m[position[item]] = last;
+        position[last] = position[item];
+        m.pop_back();
+        load[bin] -= sizes[item];
+      }
+      attach(item, undo[k].second);
+    }
+    undo.clear();
+    free_items.clear();
+  }
+
+  bool eliminate(int target, int lower_bound, SearchBudget& budget) {
+    undo.clear();
+    free_items.assign(members[target].begin(), members[target].end());
+    for (int item : free_items) detach(item);
+    closed[target] = true;
+
+    while (!free_items.empty()) {
+      if (!budget.tick(explored, polls, open, lower_bound) || !move()) {
+        closed[target] = false;
+        rollback();
+        counters.pruned_bound++;
+        return false;
+      }
+    }
+    undo.clear();
+    open--;
+    counters.improvements++;
+    if (stats) stats->improved(explored, open);
+    return true;
+  }
+
+  // One move for the free items, largest first; false if none is possible
+  bool move() {
+    std::sort(free_items.begin(), free_items.end(),
+              [&](int a, int b) { return sizes[a] != sizes[b] ? sizes[a] > sizes[b] : a < b; });
+    for (int f = 0; f < (int) free_items.size(); f++) {
+      int item = free_items[f];
+      int size = sizes[item];
+
+      // shift: fullest bin with room for the item
+      int best = -1;
+      for (int b = 0; b < (int) members.size(); b++) {
+        if (closed[b] || load[b] + size > capacity) continue;
+        if (best < 0 || load[b] > load[best]) best = b;
+      }
+      if (best >= 0) {
+        free_items.erase(free_items.begin() + f);
+        attach(item, best);
+        return true;
+      }
+
+      // swaps: the bin is left as full as possible
+      int best_fill = -1, out1 = -1, out2 = -1, partner = -1;
+      for (int b = 0; b < (int) members.size(); b++) {
+        if (closed[b]) continue;
+        const std::vector<int>& m = members[b];
+        for (int x = 0; x < (int) m.size(); x++) {
+          int sx = sizes[m[x]];
+          // 1-1
+          if (sx < size && load[b] - sx + size <= capacity && load[b] - sx + size > best_fill) {
+            best_fill = load[b] - sx + size;
+            out1 = m[x]; out2 = -1; partner = -1;
+          }
+          // 1-2
+          for (int y = x + 1; y < (int) m.size(); y++) {
+            int pair = sx + sizes[m[y]];
+            if (pair < size && load[b] - pair + size <= capacity && load[b] - pair + size > best_fill) {
+              best_fill = load[b] - pair + size;
+              out1 = m[x]; out2 = m[y]; partner = -1;
+            }
+          }
+          // 2-1
+          for (int g = f + 1; g < (int) free_items.size(); g++) {
+            int both = size + sizes[free_items[g]];
+            if (sx < both && load[b] - sx + both <= capacity && load[b] - sx + both > best_fill) {
+              best_fill = load[b] - sx + both;
+              out1 = m[x]; out2 = -1; partner = g;
+            }
+          }
+        }
+      }
+      if (best_fill < 0) continue;
+
+      int bin = bin_of[out1];
+      detach(out1);
+      if (out2 >= 0) detach(out2);
+      if (partner >= 0) {
+        attach(free_items[partner], bin);
+        free_items.erase(free_items.begin() + partner);
+      }
+      attach(item, bin);
+      free_items.erase(free_items.begin() + f);
+      free_items.push_back(out1);
+      if (out2 >= 0) free_items.push_back(out2);
+      return true;
+    }
+    return false;
+  }
+
+  // Random feasible swaps between two open bins, a few per bin
+  void kick() {
+    list_open_bins();
+    if (open_bins.size() < 2) return;
+    std::uniform_int_distribution<int> pick(0, open_bins.size() - 1);
+    int tries = 4 * open_bins.size();
+    for (int t = 0; t < tries; t++) {
+      int a = open_bins[pick(rng)], b = open_bins[pick(rng)];
+      if (a == b || members[a].empty() || members[b].empty()) continue;
+      int x = members[a][rng() % members[a].size()];
+      int y = members[b][rng() % members[b].size()];
+      int delta = sizes[y] - sizes[x];
+      if (delta == 0 || load[a] + delta > capacity || load[b] - delta > capacity) continue;
+      detach(x);
+      detach(y);
+      attach(y, a);
+      attach(x, b);
+    }
+    undo.clear();
+  }
+};
+
+#endif
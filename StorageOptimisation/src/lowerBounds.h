@@ -0,0 +1,113 @@
+#ifndef LOWER_BOUNDS_H
+#define LOWER_BOUNDS_H
+
+#include <vector>
+#include <algorithm>
+#include <functional>
+
+#include "packingState.h"
+
+// L1: total size over the capacity, rounded up
+inline int lower_bound_l1(const int* sizes, int n, int capacity) {
+  long long total = 0;
+  for (int i = 0; i < n; i++) total += sizes[i];
+  return (int) ((total + capacity - 1) / capacity);
+}
+
+// Martello-Toth L2 on sizes sorted by decreasing size, in O(n).
+// For a threshold K <= C/2, items larger than C - K (J1) and items in
+// (C/2, C - K] (J2) each need their own bin, and the items in [K, C/2] (J3)
+// can only use the room J2 leaves free, the rest needing new bins:
+//   L(K) = |J1| + |J2| + max(0, ceil((size(J3) - (|J2| C - size(J2))) / C))
+// L2 is the largest L(K) over K = 0 and the distinct sizes <= C/2. As K grows
+// J1 only gains items and J3 only loses some, so one sweep over the sorted
+// sizes with prefix sums evaluates every K.
+// The sweep runs over g groups of items of equal size, by decreasing size:
+// size_at(i) is the size of group i, items_before(i) the number of items in
+// the groups before it, and volume_before[i] their total size (g + 1
+// entries). Groups are single items, or the size classes of an input only
+// known by its classes (see filePacking.h).
+template <typename SizeAt, typename ItemsBefore>
+long long l2_sweep(int g, long long capacity, SizeAt size_at, ItemsBefore items_before,
+                   const std::vector<long long>& volume_before) {
+  int half = 0; // groups larger than C/2
+  while (half < g && 2LL * size_at(half) > capacity) half++;
+
+  long long best = (volume_before[g] + capacity - 1) / capacity;
+  int p1 = 0; // groups larger than C - K
+  auto evaluate = [&](long long k, int q) { // q: groups at least K
+    while (p1 < half && size_at(p1) > capacity - k) p1++;
+    long long j2 = items_before(half) - items_before(p1);
+    long long free_j2 = j2 * capacity - (volume_before[half] - volume_before[p1]);
+    long long extra = (volume_before[q] - volume_before[half]) - free_j2;
+    long long value = items_before(half) + (extra > 0 ? (extra + capacity - 1) / capacity : 0);
+    best = std::max(best, value);
+  };
+
+  evaluate(0, g);
+  // distinct sizes <= C/2 in increasing order, at their last position
+  for (int i = g - 1; i >= half; i--) {
+    if (i < g - 1 && size_at(i) == size_at(i + 1)) continue;
+    evaluate(size_at(i), i + 1);
+  }
+  return best;
+}
+
+// L2 of items sorted by decreasing size; `prefix` is scratch space
+inline int lower_bound_l2(const int* sizes, int n, int capacity, std::vector<long long>& prefix) {
+  prefix.resize(n + 1);
+  prefix[0] = 0;
+  for (int i = 0; i < n; i++) prefix[i + 1] = prefix[i] + sizes[i];
+  return (int) l2_sweep(n, capacity, [sizes](int i) { return sizes[i]; },
+                        [](int i) { return (long long) i; }, prefix);
+}
+
+inline int lower_bound_l2(const std::vector<int>& sorted_sizes, int capacity) {
+  std::vector<long long> prefix;
+  return lower_bound_l2(sorted_sizes.data(), (int) sorted_sizes.size(), capacity, prefix);
+}
+
+// Lower bound of a partial packing, for branch and bound nodes. Items are
+// placed by decreasing size, so the remaining items are a sorted suffix of
+// the instance that shrinks by one at each level. Bins that none of them fits
+// in are closed; the loads of the other bins are merged, as items, with the
+// remaining ones and bounded with L2. Bins that cannot be filled also waste
+// their residual, which gives the L1 style bound ceil((total + waste) / C).
+// Scratch buffers are kept between calls, so nodes do not allocate.
+class NodeBound {
+public:
+  NodeBound(int capacity, long long total) : capacity(capacity), total(total) {}
+
+  int bound(const PackingState& state, const int* remaining, int m) {
+    int closed = 0;
+    long long wasted = 0;
+    int smallest = m > 0 ? remaining[m - 1] : 0;
+    open_loads.clear();
+    for (int bin = 0; bin < state.num_bins(); bin++) {
+      if (m == 0 || state.residual[bin] < smallest) {
+        closed++;
+        wasted += state.residual[bin];
+      } else {
+        open_loads.push_back(state.load[bin]);
+      }
+    }
+    long long l1 = (total + wasted + capacity - 1) / capacity;
+
+    std::sort(open_loads.begin(), open_loads.end(), std::greater<int>());
+    merged.resize(open_loads.size() + m);
+    std::merge(open_loads.begin(), open_loads.end(), remaining, remaining + m,
+               merged.begin(), std::greater<int>());
+    int l2 = closed + lower_bound_l2(merged.data(), (int) merged.size(), capacity, prefix);
+
+    return std::max<long long>(std::max<long long>(l1, l2), state.num_bins());
+  }
+
+private:
+  int capacity;
+  long long total;
+  std::vector<int> open_loads;
+  std::vector<int> merged;
+  std::vector<long long> prefix;
+};
+
+#endif
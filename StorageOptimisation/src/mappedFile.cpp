@@ -0,0 +1,132 @@
+// System side of MappedFile, kept apart from the files including the R
+// headers: windows.h and R define some of the same macros.
+
+#include <stdexcept>
+#include <algorithm>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "mappedFile.h"
+
+MappedFile::MappedFile(const std::string& path)
+  : base(nullptr), length(0), writable(false), file(nullptr), mapping(nullptr), fd(-1) {
+  map(path, 0, false);
+}
+
+MappedFile::MappedFile(const std::string& path, std::size_t bytes)
+  : base(nullptr), length(0), writable(true), file(nullptr), mapping(nullptr), fd(-1) {
+  map(path, bytes, true);
+}
+
+MappedFile::~MappedFile() { unmap(); }
+
+void MappedFile::fail(const std::string& what, const std::string& path) {
+  unmap();
+  throw std::runtime_error("cannot " + what + " '" + path + "'");
+}
+
+#ifdef _WIN32
+void MappedFile::release(std::size_t, std::size_t) {}
+
+void MappedFile::sequential() {}
+
+bool MappedFile::same_file(const std::string& path) const {
+  HANDLE other = CreateFileA(path.c_str(), 0, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                             nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (other == INVALID_HANDLE_VALUE) return false;
+  BY_HANDLE_FILE_INFORMATION a, b;
+  bool same = GetFileInformationByHandle((HANDLE) file, &a) && GetFileInformationByHandle(other, &b) &&
+              a.dwVolumeSerialNumber == b.dwVolumeSerialNumber &&
+              a.nFileIndexHigh == b.nFileIndexHigh && a.nFileIndexLow == b.nFileIndexLow;
+  CloseHandle(other);
+  return same;
+}
+
+void MappedFile::map(const std::string& path, std::size_t bytes, bool create) {
+  HANDLE handle = CreateFileA(path.c_str(), create ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ,
+                              FILE_SHARE_READ, nullptr, create ? CREATE_ALWAYS : OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (handle == INVALID_HANDLE_VALUE) fail(create ? "create" : "open", path);
+  file = handle;
+  if (create) {
+    length = bytes;
+  } else {
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(handle, &size)) fail("read the size of", path);
+    length = (std::size_t) size.QuadPart;
+  }
+  if (length == 0) return; // empty files cannot be mapped
+  unsigned long long size = length;
+  mapping = CreateFileMappingA(handle, nullptr, create ? PAGE_READWRITE : PAGE_READONLY,
+                               (DWORD) (size >> 32), (DWORD) size, nullptr);
+  if (!mapping) fail("map", path);
+  base = (char*) MapViewOfFile((HANDLE) mapping, create ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0);
+  if (!base) fail("map", path);
+}
+
+void MappedFile::unmap() {
+  if (base) UnmapViewOfFile(base);
+  if (mapping) CloseHandle((HANDLE) mapping);
+  if (file) CloseHandle((HANDLE) file);
+  base = nullptr;
+  mapping = nullptr;
+  file = nullptr;
+}
+#else
+void MappedFile::release(std::size_t offset, std::size_t bytes) {
+  std::size_t page = sysconf(_SC_PAGESIZE);
+  std::size_t start = offset / page * page;
+  std::size_t end = std::min(length, offset + bytes);
+  if (end > start) madvise(base + start, end - start, MADV_DONTNEED);
+}
+
+void MappedFile::sequential() {
+  if (length > 0) madvise(base, length, MADV_SEQUENTIAL);
+}
+
+bool MappedFile::same_file(const std::string& path) const {
+  struct stat mine, other;
+  if (fstat(fd, &mine) != 0 || stat(path.c_str(), &other) != 0) return false;
+  return mine.st_dev == other.st_dev && mine.st_ino == other.st_ino;
+}
+
+void MappedFile::map(const std::string& path, std::size_t bytes, bool create) {
+  fd = create ? ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644)
+              : ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) fail(create ? "create" : "open", path);
+  if (create) {
+    if (ftruncate(fd, (off_t) bytes) != 0) fail("resize", path);
+    length = bytes;
+  } else {
+    struct stat info;
+    if (fstat(fd, &info) != 0) fail("read the size of", path);
+    length = info.st_size;
+  }
+  if (length == 0) return; // empty files cannot be mapped
+  void* address = mmap(nullptr, length, create ? PROT_READ | PROT_WRITE : PROT_READ,
+                       MAP_SHARED, fd, 0);
+  if (address == MAP_FAILED) fail("map", path);
+  base = (char*) address;
+}
+
+void MappedFile::unmap() {
+  if (base) {
+    if (writable) msync(base, length, MS_SYNC);
+    munmap(base, length);
+  }
+  if (fd >= 0) ::close(fd);
+  base = nullptr;
+  fd = -1;
+}
+#endif
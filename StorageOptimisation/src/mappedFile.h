@@ -0,0 +1,56 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <cstddef>
+
+// File mapped in memory, read only or created read-write with a given size.
+// The pages are only loaded when touched and written back by the system, so
+// a file larger than the RAM can be read or written through data() as long as
+// the pages done with are given back with release().
+// The system calls live in mappedFile.cpp, the only file including the
+// system headers (windows.h clashes with the R headers).
+class MappedFile {
+public:
+  // Maps an existing file, read only
+  explicit MappedFile(const std::string& path);
+
+  // Creates (or truncates) a file of `bytes` bytes and maps it read-write
+  MappedFile(const std::string& path, std::size_t bytes);
+
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  const char* data() const { return base; }
+  char* data() { return base; }
+  std::size_t size() const { return length; }
+
+  // Gives back the pages of [offset, offset + bytes) that are no longer
+  // needed; the ones written stay in the system cache until flushed to the
+  // file, so the data is kept
+  void release(std::size_t offset, std::size_t bytes);
+
+  // Pages are read in order, the system may read ahead
+  void sequential();
+
+  // True if `path` names the mapped file (same device and inode, or volume
+  // and file index), whatever the path it was opened with
+  bool same_file(const std::string& path) const;
+
+private:
+  char* base;
+  std::size_t length;
+  bool writable;
+  void* file;    // Windows handles
+  void* mapping;
+  int fd;        // POSIX descriptor
+
+  void map(const std::string& path, std::size_t bytes, bool create);
+  void unmap();
+  // Closes what was opened, the destructor not running when a constructor throws
+  void fail(const std::string& what, const std::string& path);
+};
+
+#endif
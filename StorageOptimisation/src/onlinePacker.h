@@ -0,0 +1,147 @@
+#ifndef ONLINE_PACKER_H
+#define ONLINE_PACKER_H
+
+#include <vector>
+#include <set>
+#include <algorithm>
+
+#include "residualSet.h"
+
+// Online bin packing: items arrive (and leave) one at a time and each one is
+// placed as soon as it arrives, without moving the others.
+//  - Best fit: the tightest bin able to take the item, from the same
+//    ResidualSet as BFD, O(log n).
+//  - Harmonic-k: an item of size s in (C/(j+1), C/j] belongs to class
+//    j = floor(C / s) < k and shares its bins with j - 1 items of the same
+//    class only; smaller items (class k) are packed best fit among their own
+//    bins. Every class keeps the bins that still have room, O(log n).
+// Removing an item frees its room in place; a bin left empty is closed and
+// its index is reused by the next bin opened. Items are numbered in order of
+// arrival and keep their number after being removed.
+class OnlinePacker {
+public:
+  enum Policy { BEST_FIT, HARMONIC };
+
+  OnlinePacker(int capacity, Policy policy, int classes = 1)
+    : capacity(capacity), policy(policy), classes(std::max(1, classes)), open(0),
+      room(this->classes), small(this->classes + 1) {}
+
+  // Places an item and returns its number
+  int add(int size) {
+    int item = item_size.size();
+    int cls = item_class(size);
+    int bin = policy == HARMONIC && cls < classes ? fit_slot(cls) : fit_residual(cls, size);
+    item_size.push_back(size);
+    item_bin.push_back(bin);
+    load[bin] += size;
+    count[bin]++;
+    return item;
+  }
+
+  void remove(int item) {
+    int bin = item_bin[item];
+    int size = item_size[item];
+    int cls = bin_class[bin];
+    item_bin[item] = -1;
+
+    if (policy == HARMONIC && cls < classes) {
+      if (count[bin] == cls) room[cls].insert(bin);
+      load[bin] -= size;
+      count[bin]--;
+      if (count[bin] == 0) {
+        room[cls].erase(bin);
+        close_bin(bin);
+      }
+    } else {
+      int residual = capacity - load[bin];
+      load[bin] -= size;
+      count[bin]--;
+      if (count[bin] == 0) {
+        small[cls].remove_bin(bin, residual);
+        close_bin(bin);
+      } else {
+        small[cls].update(bin, residual, residual + size);
+      }
+    }
+  }
+
+  bool contains(int item) const {
+    return item >= 0 && item < (int) item_bin.size() && item_bin[item] >= 0;
+  }
+
+  int num_items() const { return item_size.size(); }
+
+  // Bins holding at least one item
+  int num_bins() const { return open; }
+
+  // Bin slots, including the closed ones waiting to be reused
+  int num_slots() const { return load.size(); }
+
+  int bin_of(int item) const { return item_bin[item]; }
+  int size_of(int item) const { return item_size[item]; }
+  int load_of(int bin) const { return load[bin]; }
+  int bin_capacity() const { return capacity; }
+
+private:
+  int capacity;
+  Policy policy;
+  int classes;
+  int open;
+  std::vector<int> item_size, item_bin;    // by item number, bin -1 once removed
+  std::vector<int> load, count, bin_class; // by bin
+  std::vector<int> closed;                 // empty bins, reused first
+  std::vector<std::set<int>> room;         // harmonic: class j bins with < j items
+  std::vector<ResidualSet> small;          // best fit bins (class k for harmonic)
+
+  int item_class(int size) const {
+    if (policy == BEST_FIT) return classes;
+    return size > 0 ? std::min(classes, capacity / size) : classes;
+  }
+
+  int open_bin(int cls) {
+    int bin;
+    if (!closed.empty()) {
+      bin = closed.back();
+      closed.pop_back();
+      bin_class[bin] = cls;
+    } else {
+      bin = load.size();
+      load.push_back(0);
+      count.push_back(0);
+      bin_class.push_back(cls);
+    }
+    open++;
+    return bin;
+  }
+
+  void close_bin(int bin) {
+    closed.push_back(bin);
+    open--;
+  }
+
+  // Harmonic class j < k: j items per bin
+  int fit_slot(int cls) {
+    int bin;
+    if (room[cls].empty()) {
+      bin = open_bin(cls);
+      if (cls > 1) room[cls].insert(bin);
+    } else {
+      bin = *room[cls].begin();
+      if (count[bin] + 1 == cls) room[cls].erase(bin);
+    }
+    return bin;
+  }
+
+  int fit_residual(int cls, int size) {
+    int bin = small[cls].best_fit(size);
+    if (bin < 0) {
+      bin = open_bin(cls);
+      small[cls].add_bin(bin, capacity);
+    }
+    int residual = capacity - load[bin];
+    small[cls].update(bin, residual, residual - size);
+    return bin;
+  }
+};
+
+#endif
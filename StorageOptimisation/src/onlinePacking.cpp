@@ -0,0 +1,111 @@
+#include <Rcpp.h>
+using namespace Rcpp;
+using namespace std;
+
+#include <vector>
+#include <string>
+
+#include "onlinePacker.h"
+#include "rInterface.h"
+
+// Packer behind a handle of online_packer_Rcpp, see handle_object()
+static OnlinePacker& packer_from(SEXP handle) {
+  return handle_object<OnlinePacker>(handle, "online_packer", "packer");
+}
+
+//' Online bin packing: new packer
+//'
+//' Creates a packer that places games one at a time as they arrive, without
+//' moving the games already stored. See \code{add_items}.
+//' @param storage the storage size
+//' @param policy \code{"best_fit"} (the fullest storage able to take the
+//'        game) or \code{"harmonic"} (games of size in (storage / (j + 1),
+//'        storage / j] share storages j at a time, smaller ones are packed
+//'        best fit)
+//' @param classes the number k of size classes of the harmonic policy
+//' @return an external pointer to the packer
+//' @export
+// [[Rcpp::export(rng = false)]]
+SEXP online_packer_Rcpp(int storage, std::string policy = "best_fit", int classes = 4) {
+  if (storage <= 0) {
+    stop("storage must be positive");
+  }
+  OnlinePacker::Policy rule;
+  if (policy == "best_fit") {
+    rule = OnlinePacker::BEST_FIT;
+  } else if (policy == "harmonic") {
+    rule = OnlinePacker::HARMONIC;
+  } else {
+    stop("unknown policy '%s', use \"best_fit\" or \"harmonic\"", policy);
+  }
+  return make_handle(new OnlinePacker(storage, rule, classes), "online_packer");
+}
+
+//' Online bin packing: add games
+//'
+//' Places the games one after the other, in O(log n) each.
+//' @param packer a packer created by \code{online_packer_Rcpp}
+//' @param sizes the sizes of the arriving games
+//' @return a list with the numbers given to the games (\code{item}, from 1,
+//'         in order of arrival) and the storage each one was put in
+//'         (\code{bin}, from 1), with a \code{stats} attribute timing the
+//'         call
+//' @export
+// [[Rcpp::export(rng = false)]]
+List online_add_Rcpp(SEXP packer, SEXP sizes) {
+  SearchStats stats;
+  OnlinePacker& online = packer_from(packer);
+  IntegerInput games(sizes);
+  check_sizes(games.data(), games.size(), online.bin_capacity());
+
+  IntegerVector item(games.size()), bin(games.size());
+  stats.lap(stats.setup_seconds);
+  for (R_xlen_t i = 0; i < games.size(); i++) {
+    int id = online.add(games[i]);
+    item[i] = id + 1;
+    bin[i] = online.bin_of(id) + 1;
+  }
+  stats.lap(stats.search_seconds);
+  List result = List::create(Named("item") = item, Named("bin") = bin);
+  set_stats(result, stats);
+  return result;
+}
+
+//' Online bin packing: remove games
+//'
+//' Frees the room of the games, in O(log n) each. The other games stay where
+//' they are; a storage left empty is reused by the next one opened.
+//' @param packer a packer created by \code{online_packer_Rcpp}
+//' @param items the numbers of the games to remove
+//' @export
+// [[Rcpp::export(rng = false)]]
+void online_remove_Rcpp(SEXP packer, IntegerVector items) {
+  OnlinePacker& online = packer_from(packer);
+  for (int item : items) {
+    if (item == NA_INTEGER || !online.contains(item - 1)) {
+      stop("game %d is not stored", item);
+    }
+    online.remove(item - 1);
+  }
+}
+
+//' Online bin packing: current packing
+//'
+//' @param packer a packer created by \code{online_packer_Rcpp}
+//' @return a list with the storage of every game ever added (\code{bin}, NA
+//'         once removed), their sizes, the load of every storage
+//'         (\code{loads}, 0 for the empty ones) and the number of storages in
+//'         use
+//' @export
+// [[Rcpp::export(rng = false)]]
+List online_snapshot_Rcpp(SEXP packer) {
+  OnlinePacker& online = packer_from(packer);
+  IntegerVector bin(online.num_items()), size(online.num_items()), loads(online.num_slots());
+  for (int item = 0; item < online.num_items(); item++) {
+    bin[item] = online.contains(item) ? online.bin_of(item) + 1 : NA_INTEGER;
+    size[item] = online.size_of(item);
+  }
+  for (int b = 0; b < online.num_slots(); b++) loads[b] = online.load_of(b);
+  return List::create(Named("bin") = bin, Named("size") = size, Named("loads") = loads,
+                      Named("num_bins") = online.num_bins());
+}
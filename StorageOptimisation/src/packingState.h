@@ -0,0 +1,100 @@
+#ifndef PACKING_STATE_H
+#define PACKING_STATE_H
+
+#include <vector>
+#include <algorithm>
+
+// Flat packing state shared by every engine. Bin loads and residual
+// capacities live in contiguous arrays and each item only records the bin it
+// was put in, so fit checks are a single comparison and opening a bin does not
+// allocate. The nested list of bins is materialised (CSR style: offsets into a
+// single member array) only when the result is handed back to R.
+// Items are identified by their index in the engine's own size array.
+struct PackingState {
+  int capacity;
+  std::vector<int> load;       // load of each open bin
+  std::vector<int> residual;   // capacity - load of each open bin
+  std::vector<int> assignment; // bin of each item, -1 while unplaced
+
+  PackingState(int capacity, int num_items) : capacity(capacity) {
+    reset(num_items);
+  }
+
+  // Empties every bin, keeping the allocated storage
+  void reset(int num_items) {
+    load.clear();
+    residual.clear();
+    load.reserve(num_items);
+    residual.reserve(num_items);
+    assignment.assign(num_items, -1);
+  }
+
+  int num_bins() const { return (int) load.size(); }
+
+  bool fits(int bin, int size) const { return residual[bin] >= size; }
+
+  // Opens an empty bin and returns its index
+  int open_bin() {
+    load.push_back(0);
+    residual.push_back(capacity);
+    return (int) load.size() - 1;
+  }
+
+  // Closes the last opened bin, which must be empty (used when backtracking)
+  void close_bin() {
+    load.pop_back();
+    residual.pop_back();
+  }
+
+  void place(int item, int bin, int size) {
+    assignment[item] = bin;
+    load[bin] += size;
+    residual[bin] -= size;
+  }
+
+  // Places the items first .. first + count - 1, all of the same size, in one bin
+  void place_run(int first, int count, int bin, int size) {
+    std::fill(assignment.begin() + first, assignment.begin() + first + count, bin);
+    load[bin] += count * size;
+    residual[bin] -= count * size;
+  }
+
+  void remove(int item, int size) {
+    int bin = assignment[item];
+    assignment[item] = -1;
+    load[bin] -= size;
+    residual[bin] += size;
+  }
+
+  // CSR view of the bins: the items of bin b are
+  // members[offsets[b]] .. members[offsets[b + 1] - 1], in increasing item order
+  void to_csr(std::vector<int>& offsets, std::vector<int>& members) const {
+    int bins = num_bins();
+    offsets.assign(bins + 1, 0);
+    for (int bin : assignment) {
+      if (bin >= 0) offsets[bin + 1]++;
+    }
+    for (int b = 0; b < bins; b++) offsets[b + 1] += offsets[b];
+    members.resize(offsets[bins]);
+    std::vector<int> next(offsets.begin(), offsets.end() - 1);
+    for (int item = 0; item < (int) assignment.size(); item++) {
+      if (assignment[item] >= 0) members[next[assignment[item]]++] = item;
+    }
+  }
+
+  // Nested bins holding the sizes of their items, as returned to R
+  std::vector<std::vector<int>> bins(const std::vector<int>& sizes) const {
+    std::vector<int> offsets, members;
+    to_csr(offsets, members);
+    std::vector<std::vector<int>> out(num_bins());
+    for (int b = 0; b < num_bins(); b++) {
+      out[b].reserve(offsets[b + 1] - offsets[b]);
+      for (int k = offsets[b]; k < offsets[b + 1]; k++) {
+        out[b].push_back(sizes[members[k]]);
+      }
+    }
+    return out;
+  }
+};
+
+#endif
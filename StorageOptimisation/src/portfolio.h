@@ -0,0 +1,185 @@
+#ifndef PORTFOLIO_H
+#define PORTFOLIO_H
+
+#include <vector>
+#include <string>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <exception>
+#include <climits>
+
+#include "packingState.h"
+#include "greedyPacking.h"
+#include "localSearch.h"
+#include "exactSolver.h"
+#include "searchBudget.h"
+#include "searchStats.h"
+
+// Best packing found by any engine of a portfolio, with the engine that
+// found it. The bin count is an atomic, read by the exact search to prune.
+struct PortfolioIncumbent {
+  std::atomic<int> num_bins;
+  std::mutex mutex;
+  std::vector<int> assignment; // bin of every item, input order
+  std::string engine;
+
+  PortfolioIncumbent() : num_bins(INT_MAX) {}
+
+  bool offer(int bins, const std::vector<int>& candidate, const char* by) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (bins >= num_bins.load()) return false;
+    assignment = candidate;
+    engine = by;
+    num_bins.store(bins);
+    return true;
+  }
+};
+
+// Races the engines on one instance, all sharing the incumbent and the L3
+// lower bound:
+//  - FFD and BFD run at the same time, on the calling thread and a helper,
+//    once: the best of the two is also the exact search's starting packing;
+//  - then a helper thread runs the local search from that packing while the
+//    calling thread runs the exact search (on `threads - 1` workers, at
+//    least one), pruning against the shared incumbent as well as its own.
+// Whoever meets the lower bound, or the exact search completing, proves the
+// incumbent optimal and stops the others through the shared budget. Only
+// the calling thread polls the budget's hooks. However solve() is left, an
+// exception included, its helpers are stopped and joined first.
+class Portfolio {
+public:
+  // `items` is read in place (e.g. from R) and must outlive the portfolio
+  Portfolio(const int* items, int n, int capacity)
+    : items(items), n(n), capacity(capacity), exact(items, n, capacity), proven(false),
+      local_stats(nullptr) {}
+
+  // Counters of the exact and local searches (and the trace of both) of the
+  // next solve() go to `stats`
+  void collect_stats(SearchStats* stats) {
+    exact.collect_stats(stats);
+    local_stats = stats;
+  }
+
+  // Bin of every item, in input order, of the best packing found
+  std::vector<int> solve(int threads, SearchBudget& budget, unsigned seed) {
+    int lower = exact.lower_bound();
+    exact.share_bound(&incumbent.num_bins);
+
+    std::vector<int> start = greedy(budget);
+    if (incumbent.num_bins.load() <= lower) {
+      proven = true;
+      return incumbent.assignment;
+    }
+    exact.start_from(start);
+
+    Helper helper(budget);
+    helper.run([&]() { local_search(lower, budget, seed); });
+    offer_sorted(exact.solve(std::max(1, threads - 1), budget), "exact");
+    bool exact_proof = exact.optimal();
+    helper.finish();
+
+    proven = exact_proof || incumbent.num_bins.load() <= lower;
+    return incumbent.assignment;
+  }
+
+  int num_bins() const { return incumbent.num_bins.load(); }
+  int lower_bound() const { return exact.lower_bound(); }
+  bool optimal() const { return proven; }
+
+  // Engine that found the returned packing: "ffd", "bfd", "local_search"
+  // or "exact"
+  const std::string& engine() const { return incumbent.engine; }
+
+private:
+  // Helper thread, stopped through the budget and joined when the helper
+  // goes out of scope, so that an exception of the calling thread never
+  // destroys it joinable; an exception of the helper stops the budget and
+  // is raised again by finish()
+  class Helper {
+  public:
+    explicit Helper(SearchBudget& budget) : budget(budget) {}
+    ~Helper() {
+      if (thread.joinable()) {
+        budget.stop();
+        thread.join();
+      }
+    }
+
+    template <typename Work>
+    void run(Work work) {
+      thread = std::thread([this, work]() {
+        try {
+          work();
+        } catch (...) {
+          error = std::current_exception();
+          budget.stop();
+        }
+      });
+    }
+
+    // Waits for the work, after stopping it unless `stop` is false
+    void finish(bool stop = true) {
+      if (stop) budget.stop();
+      if (thread.joinable()) thread.join();
+      if (error) std::rethrow_exception(error);
+    }
+
+  private:
+    SearchBudget& budget;
+    std::thread thread;
+    std::exception_ptr error;
+  };
+
+  const int* items;
+  int n;
+  int capacity;
+  ExactSolver exact;
+  PortfolioIncumbent incumbent;
+  bool proven;
+  SearchStats* local_stats;
+
+  // Offers a packing of the exact solver's sorted items (its sorted_items()
+  // order), converted to input order
+  void offer_sorted(const std::vector<int>& sorted_assignment, const char* by) {
+    const std::vector<int>& order = exact.sorted_items();
+    std::vector<int> assignment(n);
+    int bins = 0;
+    for (int k = 0; k < n; k++) {
+      assignment[order[k]] = sorted_assignment[k];
+      bins = std::max(bins, sorted_assignment[k] + 1);
+    }
+    incumbent.offer(bins, assignment, by);
+  }
+
+  // FFD on this thread and BFD on a helper, over the exact solver's sorted
+  // copy; both are offered, the best is returned (sorted order)
+  std::vector<int> greedy(SearchBudget& budget) {
+    const std::vector<int>& sorted = exact.sorted_sizes();
+    PackingState ffd(capacity, n), bfd(capacity, n);
+    {
+      Helper helper(budget);
+      helper.run([&]() { pack_best_fit(sorted.data(), n, bfd); });
+      pack_first_fit(sorted.data(), n, ffd);
+      helper.finish(false);
+    }
+    offer_sorted(ffd.assignment, "ffd");
+    offer_sorted(bfd.assignment, "bfd");
+    return bfd.num_bins() < ffd.num_bins() ? bfd.assignment : ffd.assignment;
+  }
+
+  void local_search(int lower, SearchBudget& budget, unsigned seed) {
+    std::vector<int> start;
+    {
+      std::lock_guard<std::mutex> lock(incumbent.mutex);
+      start = incumbent.assignment;
+    }
+    LocalSearch search(items, n, capacity, start.data(), seed);
+    search.collect_stats(local_stats);
+    int bins = search.improve(lower, budget, false);
+    incumbent.offer(bins, search.assignment(), "local_search");
+    if (bins <= lower) budget.stop();
+  }
+};
+
+#endif
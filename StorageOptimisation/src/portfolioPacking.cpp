@@ -0,0 +1,67 @@
+#include <Rcpp.h>
+using namespace Rcpp;
+using namespace std;
+
+#include <vector>
+#include <thread>
+
+#include "portfolio.h"
+#include "searchBudget.h"
+#include "rInterface.h"
+
+//' Portfolio bin packing using C++
+//'
+//' Single entry point racing the engines on one instance: first-fit and
+//' best-fit decreasing followed by the local search of
+//' \code{improve_packing_Rcpp} on one thread, and the exact search of
+//' \code{exact_bin_packing_Rcpp} on the others. They share the best packing
+//' found and the L3 lower bound: as soon as a packing meets the bound, or the
+//' exact search completes, the others are stopped. The time and node budget
+//' covers all of them.
+//' @param games a vector of games' sizes
+//' @param storage the storage size
+//' @param threads number of threads, 0 to use every core; the exact search
+//'        gets all of them but one, and at least one
+//' @param time_limit maximal running time in seconds, 0 for no limit
+//' @param max_nodes maximal number of search nodes, 0 for no limit
+//' @param seed seed of the local search
+//' @param progress an optional function, called about once per second with a
+//'        list (nodes, elapsed, num_bins, lower_bound) describing the search
+//' @return a list of vectors representing the storages, where each one
+//'         contains the sizes of its games, in input order, with the
+//'         attributes \code{assignment} (the storage of every game, numbered
+//'         from 1), \code{lower_bound}, \code{gap}, \code{optimal} and
+//'         \code{engine}, the engine which found the packing (\code{"ffd"},
+//'         \code{"bfd"}, \code{"local_search"} or \code{"exact"}), and
+//'         \code{stats}, the counters of the exact and local searches summed,
+//'         seconds per phase and, with
+//'         \code{options(StorageOptimisation.trace = TRUE)}, the trace of the
+//'         improvements of either
+//' @export
+// [[Rcpp::export]]
+List pack_Rcpp(SEXP games, int storage, int threads = 0, double time_limit = 0,
+               double max_nodes = 0, int seed = 1, Nullable<Function> progress = R_NilValue) {
+  SearchStats stats(trace_requested());
+  IntegerInput input(games);
+  check_sizes(input.data(), input.size(), storage);
+
+  SearchBudget budget(time_limit, (long long) max_nodes);
+  connect_budget(budget, progress);
+  if (threads <= 0) threads = max(1u, thread::hardware_concurrency());
+
+  Portfolio portfolio(input.data(), input.size(), storage);
+  portfolio.collect_stats(&stats);
+  stats.lap(stats.setup_seconds);
+  std::vector<int> assignment = portfolio.solve(threads, budget, seed);
+  budget.rethrow();
+  stats.lap(stats.search_seconds);
+
+  IntegerVector bin(assignment.begin(), assignment.end());
+  for (int& b : bin) b++;
+  List bins = bins_list(input.data(), bin.begin(), input.size(), portfolio.num_bins(), 1);
+  bins.attr("assignment") = bin;
+  set_search_attributes(bins, portfolio.num_bins(), portfolio.lower_bound(), portfolio.optimal());
+  bins.attr("engine") = portfolio.engine();
+  set_stats(bins, stats);
+  return bins;
+}
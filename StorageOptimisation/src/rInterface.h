@@ -0,0 +1,230 @@
+#ifndef R_INTERFACE_H
+#define R_INTERFACE_H
+
+// Glue between the pure C++ engines and R. The engines' headers never
+// include Rcpp; everything that touches the R API goes through here.
+
+#include <Rcpp.h>
+
+#include <vector>
+#include <cmath>
+#include <climits>
+
+#include "packingState.h"
+#include "searchBudget.h"
+#include "indexSort.h"
+#include "searchStats.h"
+
+// Read-only view of the sizes passed from R. Plain integer vectors are read
+// in place, without the copy an std::vector argument costs; ALTREP integer
+// vectors that have no data pointer (compact sequences, ...) are copied by
+// regions without being materialised, and doubles are converted as long as
+// they hold whole numbers.
+class IntegerInput {
+public:
+  explicit IntegerInput(SEXP x) : values(nullptr), length(XLENGTH(x)) {
+    if (TYPEOF(x) == INTSXP) {
+      values = (const int*) DATAPTR_OR_NULL(x);
+      if (values == nullptr) {
+        copy.resize(length);
+        INTEGER_GET_REGION(x, 0, length, copy.data());
+        values = copy.data();
+      }
+    } else if (TYPEOF(x) == REALSXP) {
+      const double* real = REAL(x);
+      copy.resize(length);
+      for (R_xlen_t i = 0; i < length; i++) {
+        if (std::isnan(real[i])) {
+          Rcpp::stop("the size of game %d is NA", (int) (i + 1));
+        }
+        if (!(real[i] == std::floor(real[i]) && std::fabs(real[i]) <= INT_MAX)) {
+          Rcpp::stop("sizes must be whole numbers");
+        }
+        copy[i] = (int) real[i];
+      }
+      values = copy.data();
+    } else {
+      Rcpp::stop("sizes must be an integer or numeric vector");
+    }
+  }
+
+  const int* data() const { return values; }
+  R_xlen_t size() const { return length; }
+  int operator[](R_xlen_t i) const { return values[i]; }
+
+private:
+  const int* values;
+  R_xlen_t length;
+  std::vector<int> copy;
+};
+
+// Stops unless the capacity is positive and every size is in [0, capacity]:
+// the engines assume it (the bounds divide by the capacity, even with no
+// items), and the index sorts need non-negative sizes
+inline void check_sizes(const int* sizes, R_xlen_t n, int capacity) {
+  if (capacity == NA_INTEGER || capacity <= 0) {
+    Rcpp::stop("storage must be positive");
+  }
+  for (R_xlen_t i = 0; i < n; i++) {
+    if (sizes[i] == NA_INTEGER) {
+      Rcpp::stop("the size of game %d is NA", (int) (i + 1));
+    }
+    if (sizes[i] < 0 || sizes[i] > capacity) {
+      Rcpp::stop("game %d does not fit in an empty storage", (int) (i + 1));
+    }
+  }
+}
+
+inline void check_sizes(const std::vector<int>& sizes, int capacity) {
+  check_sizes(sizes.data(), sizes.size(), capacity);
+}
+
+// Sizes passed from R, checked and put in decreasing order by an index sort:
+// `sizes` holds them in that order and input_index[k] is the input position
+// of sizes[k]
+struct SortedInput {
+  std::vector<int> sizes;
+  std::vector<int> input_index;
+
+  SortedInput(SEXP x, int capacity) : SortedInput(IntegerInput(x), capacity) {}
+
+  // From sizes already read, when the caller needs them in input order too
+  SortedInput(const IntegerInput& input, int capacity) {
+    if (input.size() > INT_MAX) {
+      Rcpp::stop("at most %d games can be packed at once", INT_MAX);
+    }
+    check_sizes(input.data(), input.size(), capacity);
+    IndexSorter sorter;
+    sorter.sort(input.data(), input.size(), input_index);
+    sizes.resize(input_index.size());
+    for (int k = 0; k < (int) sizes.size(); k++) sizes[k] = input[input_index[k]];
+  }
+};
+
+// Bin of every input item, numbered from 1, from an engine's assignment of
+// its sorted items, where input_index[k] is the input position of the
+// sorted item k
+inline Rcpp::IntegerVector input_assignment(const std::vector<int>& sorted_assignment,
+                                            const std::vector<int>& input_index) {
+  Rcpp::IntegerVector bin(sorted_assignment.size());
+  for (int k = 0; k < (int) sorted_assignment.size(); k++) {
+    bin[input_index[k]] = sorted_assignment[k] + 1;
+  }
+  return bin;
+}
+
+// Nested list of bins holding the sizes of their items, in increasing item
+// order, written straight into R vectors from the bin of every item
+// (numbered from `first`). Only built when a nested result is asked for.
+inline Rcpp::List bins_list(const int* sizes, const int* bin, R_xlen_t n, int num_bins, int first = 0) {
+  std::vector<int> count(num_bins, 0);
+  for (R_xlen_t i = 0; i < n; i++) count[bin[i] - first]++;
+
+  Rcpp::List out(num_bins);
+  std::vector<int*> next(num_bins);
+  for (int b = 0; b < num_bins; b++) {
+    Rcpp::IntegerVector members(count[b]);
+    next[b] = members.begin();
+    out[b] = members;
+  }
+  for (R_xlen_t i = 0; i < n; i++) *next[bin[i] - first]++ = sizes[i];
+  return out;
+}
+
+inline Rcpp::List bins_list(const PackingState& state, const std::vector<int>& sizes) {
+  return bins_list(sizes.data(), state.assignment.data(), sizes.size(), state.num_bins());
+}
+
+// Lets the user interrupt the search and, if `progress` is an R function,
+// calls it with list(nodes, elapsed, num_bins, lower_bound) about once per
+// second
+inline void connect_budget(SearchBudget& budget, Rcpp::Nullable<Rcpp::Function> progress) {
+  budget.check = []() { Rcpp::checkUserInterrupt(); };
+  if (progress.isNotNull()) {
+    Rcpp::Function report(progress.get());
+    budget.progress = [report](const SearchProgress& p) {
+      report(Rcpp::List::create(Rcpp::Named("nodes") = (double) p.nodes,
+                                Rcpp::Named("elapsed") = p.elapsed,
+                                Rcpp::Named("num_bins") = p.num_bins,
+                                Rcpp::Named("lower_bound") = p.lower_bound));
+    };
+  }
+}
+
+// Outcome of a budgeted search, attached to its result: the best lower bound
+// known (the number of bins itself once the packing is proven optimal), the
+// gap in bins between the two, and whether the packing is proven optimal
+template <typename T>
+void set_search_attributes(T& result, int num_bins, int lower_bound, bool optimal) {
+  if (optimal) lower_bound = num_bins;
+  result.attr("lower_bound") = lower_bound;
+  result.attr("gap") = num_bins - lower_bound;
+  result.attr("optimal") = optimal;
+}
+
+// True when the searches should record their trace, i.e. when
+// options(StorageOptimisation.trace = TRUE) is set
+inline bool trace_requested() {
+  Rcpp::Function get_option("getOption");
+  return Rcpp::as<bool>(get_option("StorageOptimisation.trace", false));
+}
+
+// Statistics of a call, attached to its result as the "stats" attribute: the
+// search counters, the seconds spent in each phase and, when tracing, the
+// incumbent improvements as a data frame (NULL otherwise). The time taken to
+// build the result so far is counted as marshalling.
+template <typename T>
+void set_stats(T& result, SearchStats& stats) {
+  stats.lap(stats.marshal_seconds);
+  Rcpp::RObject trace; // NULL, and kept protected once set
+  if (stats.tracing_enabled()) {
+    int count = stats.trace.size();
+    Rcpp::NumericVector elapsed(count), nodes(count);
+    Rcpp::IntegerVector num_bins(count);
+    for (int k = 0; k < count; k++) {
+      elapsed[k] = stats.trace[k].elapsed;
+      nodes[k] = (double) stats.trace[k].nodes;
+      num_bins[k] = stats.trace[k].num_bins;
+    }
+    trace = Rcpp::DataFrame::create(Rcpp::Named("elapsed") = elapsed,
+                                    Rcpp::Named("nodes") = nodes,
+                                    Rcpp::Named("num_bins") = num_bins);
+  }
+  const SearchCounters& c = stats.counters;
+  result.attr("stats") = Rcpp::List::create(
+    Rcpp::Named("nodes") = (double) c.nodes,
+    Rcpp::Named("pruned_bound") = (double) c.pruned_bound,
+    Rcpp::Named("pruned_symmetry") = (double) c.pruned_symmetry,
+    Rcpp::Named("pruned_incumbent") = (double) c.pruned_incumbent,
+    Rcpp::Named("improvements") = (double) c.improvements,
+    Rcpp::Named("setup_seconds") = stats.setup_seconds,
+    Rcpp::Named("search_seconds") = stats.search_seconds,
+    Rcpp::Named("marshal_seconds") = stats.marshal_seconds,
+    Rcpp::Named("trace") = trace);
+}
+
+// Handles of the stateful engines (online packer, repacker): an external
+// pointer tagged with the symbol `tag`, deleting the object when collected
+template <typename T>
+Rcpp::XPtr<T> make_handle(T* object, const char* tag) {
+  Rcpp::XPtr<T> handle(object, true, Rf_install(tag));
+  handle.attr("class") = tag;
+  return handle;
+}
+
+// Object behind a handle made by make_handle() with the same tag. Stops on
+// anything else, so that a handle of another engine is never read as this
+// one, and on a handle saved and reloaded with the session (a null pointer)
+template <typename T>
+T& handle_object(SEXP handle, const char* tag, const char* what) {
+  if (TYPEOF(handle) != EXTPTRSXP || R_ExternalPtrTag(handle) != Rf_install(tag)) {
+    Rcpp::stop("not a %s handle", what);
+  }
+  T* object = (T*) R_ExternalPtrAddr(handle);
+  if (object == nullptr) {
+    Rcpp::stop("the %s is no longer valid, create a new one", what);
+  }
+  return *object;
+}
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef REDUCTION_H
+#define REDUCTION_H
+
+#include <vector>
+#include <set>
+#include <utility>
+#include <limits>
+
+#include "lowerBounds.h"
+
+// Items fixed in their own bins before the search, and the items left
+struct Reduction {
+  std::vector<std::vector<int>> fixed; // fixed bins, as item indices
+  std::vector<int> free;               // remaining items, still sorted
+};
+
+// Martello-Toth style reduction (MTRP) on sizes sorted by decreasing size.
+// For an item i, let j be the largest other item that fits with it. The bin
+// {i, j} dominates every other bin holding i, and can be fixed, when
+//  - no item fits with i at all (then the bin is {i} alone),
+//  - i and j fill the bin exactly, or
+//  - no two other items fit together with i, so bins with i hold one more
+//    item at most, and j is the largest of them.
+// In each case some optimal packing uses that bin (swap j with the rest of
+// i's bin). Fixing bins frees no room for the others, so the rules are
+// applied again until nothing changes. O(n log n) per pass.
+inline Reduction reduce(const std::vector<int>& sizes, int capacity) {
+  int n = sizes.size();
+  Reduction reduction;
+  std::set<std::pair<int, int>> free_items; // (size, index)
+  for (int i = 0; i < n; i++) free_items.insert(std::make_pair(sizes[i], i));
+
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (int i = 0; i < n; i++) {
+      if (!free_items.count(std::make_pair(sizes[i], i))) continue;
+      int room = capacity - sizes[i];
+
+      // largest other free item fitting with i
+      int j = -1;
+      auto it = free_items.upper_bound(std::make_pair(room, std::numeric_limits<int>::max()));
+      while (it != free_items.begin()) {
+        --it;
+        if (it->second != i) {
+          j = it->second;
+          break;
+        }
+      }
+
+      bool fix = false;
+      if (j < 0) {
+        fix = true;
+      } else if (sizes[i] + sizes[j] == capacity) {
+        fix = true;
+      } else {
+        // two smallest free items other than i
+        long long smallest = 0;
+        int found = 0;
+        for (auto s = free_items.begin(); s != free_items.end() && found < 2; ++s) {
+          if (s->second == i) continue;
+          smallest += s->first;
+          found++;
+        }
+        fix = found < 2 || smallest > room;
+      }
+      if (!fix) continue;
+
+      free_items.erase(std::make_pair(sizes[i], i));
+      std::vector<int> bin(1, i);
+      if (j >= 0) {
+        free_items.erase(std::make_pair(sizes[j], j));
+        bin.push_back(j);
+      }
+      reduction.fixed.push_back(bin);
+      changed = true;
+    }
+  }
+
+  for (int i = 0; i < n; i++) {
+    if (free_items.count(std::make_pair(sizes[i], i))) reduction.free.push_back(i);
+  }
+  return reduction;
+}
+
+// L3: bins fixed by the reduction plus L2 of the items it leaves, never
+// below L2 of the whole instance
+inline int lower_bound_l3(const std::vector<int>& sizes, int capacity) {
+  Reduction reduction = reduce(sizes, capacity);
+  std::vector<int> rest;
+  for (int i : reduction.free) rest.push_back(sizes[i]);
+  int l3 = reduction.fixed.size() + lower_bound_l2(rest, capacity);
+  return std::max(l3, lower_bound_l2(sizes, capacity));
+}
+
+#endif
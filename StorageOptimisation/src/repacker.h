@@ -0,0 +1,301 @@
+#ifndef REPACKER_H
+#define REPACKER_H
+
+#include <vector>
+#include <set>
+#include <utility>
+#include <algorithm>
+#include <unordered_map>
+
+#include "residualSet.h"
+
+// Incremental repacking: a packing kept up to date as items are added,
+// resized and removed, moving as few items as possible. The bins' loads,
+// items and residuals are kept between deltas, so applying one costs
+// O(delta log n) plus the bins emptied to meet the target, never O(n):
+//  1. removed items free their room in place, shrunk items stay where they
+//     are, and so do grown items still fitting in their bin; a grown item
+//     that no longer fits is moved, or, when moves are counted by size and
+//     it is cheaper, the smallest items of its bin are moved out instead;
+//  2. new items and the items to move, largest first, go best fit into the
+//     open bins, a new bin being opened only when none fits;
+//  3. while more bins than the target are open, one of the CANDIDATES
+//     cheapest bins (fewest items, or smallest load) is emptied: its items
+//     are moved best fit into the other bins, the attempt being undone if
+//     one of them fits nowhere.
+// Items are numbered in order of arrival, those of the initial packing
+// first, and keep their number after being removed; a bin left empty is
+// closed and its index reused, as in OnlinePacker.
+class Repacker {
+public:
+  static const int CANDIDATES = 8; // bins tried per elimination
+
+  enum Cost { MOVED_ITEMS, MOVED_SIZE };
+
+  // Final bin of an item whose bin changed during a delta, from its bin
+  // before the delta (-1 for a new item)
+  struct Move {
+    int item;
+    int from;
+    int to;
+  };
+
+  // Starts from a feasible packing: `bin` gives the bin of every item,
+  // numbered from 0 (gaps become closed bins)
+  Repacker(int capacity, const int* sizes, const int* bin, int n, Cost cost)
+    : capacity(capacity), cost(cost), open(0) {
+    for (int i = 0; i < n; i++) {
+      while (bin[i] >= (int) load.size()) new_slot();
+      if (!is_open[bin[i]]) reopen(bin[i]);
+      item_size.push_back(sizes[i]);
+      item_bin.push_back(-1);
+      position.push_back(-1);
+      attach(i, bin[i]);
+    }
+    // the lowest closed bin is reused first
+    for (int b = (int) load.size() - 1; b >= 0; b--) {
+      if (!is_open[b]) closed.push_back(b);
+    }
+  }
+
+  int num_items() const { return item_size.size(); }
+  int num_bins() const { return open; }
+  int num_slots() const { return load.size(); }
+  int bin_capacity() const { return capacity; }
+
+  bool contains(int item) const {
+    return item >= 0 && item < (int) item_bin.size() && item_bin[item] >= 0;
+  }
+
+  int bin_of(int item) const { return item_bin[item]; }
+  int size_of(int item) const { return item_size[item]; }
+  int load_of(int bin) const { return load[bin]; }
+
+  // Applies a delta: items removed, items resized (new sizes at most the
+  // capacity) and new items, numbered from num_items() on in the order
+  // given. Then empties bins down to `target` bins if possible (0: as many
+  // as before the delta). Returns the items whose bin changed, new items
+  // included.
+  std::vector<Move> apply(const std::vector<int>& removed,
+                          const std::vector<std::pair<int, int>>& resized,
+                          const std::vector<int>& added, int target) {
+    if (target <= 0) target = open;
+    origin.clear();
+    pending.clear();
+
+    for (int item : removed) detach(item);
+    for (const std::pair<int, int>& change : resized) resize(change.first, change.second);
+    for (int size : added) {
+      int item = item_size.size();
+      item_size.push_back(size);
+      item_bin.push_back(-1);
+      position.push_back(-1);
+      origin[item] = -1;
+      pending.push_back(item);
+    }
+
+    std::sort(pending.begin(), pending.end(), [&](int a, int b) {
+      return item_size[a] != item_size[b] ? item_size[a] > item_size[b] : a < b;
+    });
+    for (int item : pending) {
+      int bin = fits.best_fit(item_size[item]);
+      if (bin < 0) bin = reopen(next_slot());
+      attach(item, bin);
+    }
+
+    while (open > target && eliminate_one()) {}
+
+    std::vector<Move> moves;
+    for (const auto& entry : origin) {
+      int item = entry.first;
+      if (item_bin[item] != entry.second) moves.push_back(Move{item, entry.second, item_bin[item]});
+    }
+    std::sort(moves.begin(), moves.end(), [](const Move& a, const Move& b) { return a.item < b.item; });
+    return moves;
+  }
+
+private:
+  int capacity;
+  Cost cost;
+  int open;
+  std::vector<int> item_size, item_bin, position; // by item, bin -1 once removed
+  std::vector<int> load;                           // by bin
+  std::vector<std::vector<int>> members;           // items of every bin
+  std::vector<bool> is_open;
+  std::vector<int> closed;                         // empty bins, reused first
+  ResidualSet fits;                                // open bins by residual
+  std::set<std::pair<long long, int>> cheapest;    // open bins by cost of emptying
+  std::unordered_map<int, int> origin;             // bin before the delta of the items moved
+  std::vector<int> pending;                        // items to place
+  int emptying = -1;                               // bin being emptied, out of `fits`
+
+  long long bin_cost(int bin) const {
+    return cost == MOVED_ITEMS ? (long long) members[bin].size() : (long long) load[bin];
+  }
+
+  void new_slot() {
+    load.push_back(0);
+    members.emplace_back();
+    is_open.push_back(false);
+  }
+
+  int next_slot() {
+    if (closed.empty()) new_slot();
+    else return closed.back();
+    return load.size() - 1;
+  }
+
+  // Opens an empty bin slot
+  int reopen(int bin) {
+    if (!closed.empty() && closed.back() == bin) closed.pop_back();
+    is_open[bin] = true;
+    open++;
+    fits.add_bin(bin, capacity);
+    cheapest.insert(std::make_pair(0LL, bin));
+    return bin;
+  }
+
+  void close(int bin) {
+    fits.remove_bin(bin, capacity);
+    cheapest.erase(std::make_pair(0LL, bin));
+    is_open[bin] = false;
+    open--;
+    closed.push_back(bin);
+  }
+
+  // Puts an item in an open bin, keeping the search structures up to date
+  void attach(int item, int bin) {
+    int residual = capacity - load[bin];
+    cheapest.erase(std::make_pair(bin_cost(bin), bin));
+    item_bin[item] = bin;
+    position[item] = members[bin].size();
+    members[bin].push_back(item);
+    load[bin] += item_size[item];
+    fits.update(bin, residual, residual - item_size[item]);
+    cheapest.insert(std::make_pair(bin_cost(bin), bin));
+  }
+
+  // Takes an item out of its bin, closing the bin if it is left empty
+  void detach(int item) {
+    int bin = item_bin[item];
+    take_out(item);
+    if (members[bin].empty()) close(bin);
+  }
+
+  // Takes an item out to place it again, remembering where it was
+  void unplace(int item) {
+    if (!origin.count(item)) origin[item] = item_bin[item];
+    detach(item);
+    pending.push_back(item);
+  }
+
+  void resize(int item, int size) {
+    int bin = item_bin[item];
+    if (bin < 0) { // already waiting to be placed
+      item_size[item] = size;
+      return;
+    }
+    int grow = size - item_size[item];
+    if (load[bin] + grow <= capacity) {
+      int residual = capacity - load[bin];
+      cheapest.erase(std::make_pair(bin_cost(bin), bin));
+      load[bin] += grow;
+      item_size[item] = size;
+      fits.update(bin, residual, residual - grow);
+      cheapest.insert(std::make_pair(bin_cost(bin), bin));
+      return;
+    }
+    // by size, moving the smallest other items out may be cheaper
+    if (cost == MOVED_SIZE) {
+      std::vector<int> others;
+      for (int other : members[bin]) {
+        if (other != item) others.push_back(other);
+      }
+      std::sort(others.begin(), others.end(), [&](int a, int b) {
+        return item_size[a] != item_size[b] ? item_size[a] < item_size[b] : a < b;
+      });
+      int excess = load[bin] + grow - capacity;
+      long long freed = 0;
+      int k = 0;
+      while (k < (int) others.size() && freed < excess) freed += item_size[others[k++]];
+      if (freed >= excess && freed < size) {
+        for (int j = 0; j < k; j++) unplace(others[j]);
+        resize(item, size);
+        return;
+      }
+    }
+    unplace(item);
+    item_size[item] = size;
+  }
+
+  // Empties one of the cheapest bins into the others; false if none can be
+  bool eliminate_one() {
+    std::vector<int> candidates;
+    for (auto it = cheapest.begin(); it != cheapest.end() && (int) candidates.size() < CANDIDATES; ++it) {
+      candidates.push_back(it->second);
+    }
+    for (int bin : candidates) {
+      if (empty_bin(bin)) return true;
+    }
+    return false;
+  }
+
+  bool empty_bin(int bin) {
+    std::vector<int> items(members[bin]);
+    std::sort(items.begin(), items.end(), [&](int a, int b) {
+      return item_size[a] != item_size[b] ? item_size[a] > item_size[b] : a < b;
+    });
+    // out of `fits` meanwhile, so that it does not take its own items back
+    fits.remove_bin(bin, capacity - load[bin]);
+    emptying = bin;
+    int moved = 0;
+    for (int item : items) {
+      int to = fits.best_fit(item_size[item]);
+      if (to < 0) break;
+      if (!origin.count(item)) origin[item] = bin;
+      take_out(item);
+      attach(item, to);
+      moved++;
+    }
+    emptying = -1;
+    if (moved < (int) items.size()) {
+      for (int k = 0; k < moved; k++) {
+        take_out(items[k]);
+        put_back(items[k], bin);
+      }
+      fits.add_bin(bin, capacity - load[bin]);
+      return false;
+    }
+    fits.add_bin(bin, capacity);
+    close(bin);
+    return true;
+  }
+
+  // Takes an item out of its bin, which stays open
+  void take_out(int item) {
+    int bin = item_bin[item];
+    int residual = capacity - load[bin];
+    cheapest.erase(std::make_pair(bin_cost(bin), bin));
+    std::vector<int>& m = members[bin];
+    int last = m.back();
+    m[position[item]] = last;
+    position[last] = position[item];
+    m.pop_back();
+    load[bin] -= item_size[item];
+    if (bin != emptying) fits.update(bin, residual, residual + item_size[item]);
+    cheapest.insert(std::make_pair(bin_cost(bin), bin));
+    item_bin[item] = -1;
+  }
+
+  // Puts an item back in the bin being emptied, which is out of `fits`
+  void put_back(int item, int bin) {
+    cheapest.erase(std::make_pair(bin_cost(bin), bin));
+    item_bin[item] = bin;
+    position[item] = members[bin].size();
+    members[bin].push_back(item);
+    load[bin] += item_size[item];
+    cheapest.insert(std::make_pair(bin_cost(bin), bin));
+  }
+};
+
+#endif
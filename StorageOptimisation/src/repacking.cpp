@@ -0,0 +1,168 @@
+#include <Rcpp.h>
+using namespace Rcpp;
+using namespace std;
+
+#include <vector>
+#include <string>
+#include <utility>
+#include <unordered_set>
+
+#include "repacker.h"
+#include "rInterface.h"
+
+// Repacker behind a handle of repacker_Rcpp, see handle_object()
+static Repacker& repacker_from(SEXP handle) {
+  return handle_object<Repacker>(handle, "repacker", "repacker");
+}
+
+// Stops unless the numbers are distinct games still stored
+static void check_items(const Repacker& repacker, IntegerVector items,
+                        std::unordered_set<int>& seen) {
+  for (int item : items) {
+    if (item == NA_INTEGER || !repacker.contains(item - 1)) {
+      stop("game %d is not stored", item);
+    }
+    if (!seen.insert(item).second) {
+      stop("game %d is changed twice", item);
+    }
+  }
+}
+
+//' Incremental repacking: new repacker
+//'
+//' Loads an existing packing, in O(n), so that later changes of the
+//' inventory can be applied with \code{repack_Rcpp} in time proportional to
+//' the change.
+//' @param sizes a vector of games' sizes
+//' @param assignment the storage of every game, numbered from 1 to the
+//'        number of games
+//' @param storage the storage size
+//' @param cost what a move costs: \code{"items"} (the number of games moved)
+//'        or \code{"size"} (their total size)
+//' @return an external pointer to the repacker; games are numbered from 1
+//'         in the order of \code{sizes}
+//' @export
+// [[Rcpp::export(rng = false)]]
+SEXP repacker_Rcpp(SEXP sizes, IntegerVector assignment, int storage, std::string cost = "items") {
+  if (storage <= 0) {
+    stop("storage must be positive");
+  }
+  Repacker::Cost rule;
+  if (cost == "items") {
+    rule = Repacker::MOVED_ITEMS;
+  } else if (cost == "size") {
+    rule = Repacker::MOVED_SIZE;
+  } else {
+    stop("unknown cost '%s', use \"items\" or \"size\"", cost);
+  }
+  IntegerInput games(sizes);
+  R_xlen_t n = games.size();
+  check_sizes(games.data(), n, storage);
+  if (assignment.size() != n) {
+    stop("assignment must give the storage of every game");
+  }
+  std::vector<int> bin(n);
+  std::vector<long long> load;
+  for (R_xlen_t i = 0; i < n; i++) {
+    // never more storages than games, so that the numbers stay dense
+    if (assignment[i] == NA_INTEGER || assignment[i] < 1 || assignment[i] > n) {
+      stop("game %d is not in a storage numbered from 1 to %d", (int) (i + 1), (int) n);
+    }
+    bin[i] = assignment[i] - 1;
+    if (bin[i] >= (int) load.size()) load.resize(bin[i] + 1, 0);
+    load[bin[i]] += games[i];
+  }
+  for (int b = 0; b < (int) load.size(); b++) {
+    if (load[b] > storage) {
+      stop("storage %d holds more than the storage size", b + 1);
+    }
+  }
+  return make_handle(new Repacker(storage, games.data(), bin.data(), n, rule), "repacker");
+}
+
+//' Incremental repacking: apply a change of the inventory
+//'
+//' Games removed free their room in place, games resized stay in their
+//' storage while they fit, and the games left without a storage (new ones,
+//' and grown ones that no longer fit) go best fit into the storages in use.
+//' Then, while more than \code{target} storages are used, the cheapest ones
+//' to empty are emptied into the others. The cost is O(k log n) for k
+//' changes, plus the storages emptied, whatever the number n of games.
+//' @param repacker a repacker created by \code{repacker_Rcpp}
+//' @param add the sizes of the new games
+//' @param remove the numbers of the games removed
+//' @param resize the numbers of the games resized
+//' @param new_sizes their new sizes
+//' @param target the number of storages to come back to, 0 for as many as
+//'        before the change
+//' @return a list with the numbers given to the new games (\code{added},
+//'         numbered on from the last game), the games whose storage changed
+//'         (\code{moves}: \code{item}, \code{from} (NA for a new game) and
+//'         \code{to}), the number and total size of the stored games moved,
+//'         the number of storages in use and whether it is within the target
+//' @export
+// [[Rcpp::export(rng = false)]]
+List repack_Rcpp(SEXP repacker, SEXP add, IntegerVector remove, IntegerVector resize,
+                 SEXP new_sizes, int target = 0) {
+  Repacker& packer = repacker_from(repacker);
+  IntegerInput added(add), grown(new_sizes);
+  check_sizes(added.data(), added.size(), packer.bin_capacity());
+  if (grown.size() != resize.size()) {
+    stop("new_sizes must give the new size of every game resized");
+  }
+  check_sizes(grown.data(), grown.size(), packer.bin_capacity());
+  std::unordered_set<int> seen;
+  check_items(packer, remove, seen);
+  check_items(packer, resize, seen);
+
+  std::vector<int> removed(remove.size()), sizes(added.data(), added.data() + added.size());
+  std::vector<std::pair<int, int>> resized(resize.size());
+  for (int k = 0; k < (int) remove.size(); k++) removed[k] = remove[k] - 1;
+  for (int k = 0; k < (int) resize.size(); k++) resized[k] = std::make_pair(resize[k] - 1, grown[k]);
+  int first_added = packer.num_items();
+  int before = packer.num_bins();
+
+  std::vector<Repacker::Move> moves = packer.apply(removed, resized, sizes, target);
+
+  IntegerVector item(moves.size()), from(moves.size()), to(moves.size());
+  int moved = 0;
+  double moved_size = 0;
+  for (int k = 0; k < (int) moves.size(); k++) {
+    item[k] = moves[k].item + 1;
+    from[k] = moves[k].from < 0 ? NA_INTEGER : moves[k].from + 1;
+    to[k] = moves[k].to + 1;
+    if (moves[k].from >= 0) {
+      moved++;
+      moved_size += packer.size_of(moves[k].item);
+    }
+  }
+  IntegerVector new_items(sizes.size());
+  for (int k = 0; k < (int) sizes.size(); k++) new_items[k] = first_added + k + 1;
+  return List::create(Named("added") = new_items,
+                      Named("moves") = DataFrame::create(Named("item") = item, Named("from") = from,
+                                                         Named("to") = to),
+                      Named("moved") = moved, Named("moved_size") = moved_size,
+                      Named("num_bins") = packer.num_bins(),
+                      Named("within_target") = packer.num_bins() <= (target > 0 ? target : before));
+}
+
+//' Incremental repacking: current packing
+//'
+//' @param repacker a repacker created by \code{repacker_Rcpp}
+//' @return a list with the storage of every game ever stored (\code{bin},
+//'         NA once removed), their sizes, the load of every storage
+//'         (\code{loads}, 0 for the empty ones) and the number of storages in
+//'         use
+//' @export
+// [[Rcpp::export(rng = false)]]
+List repacker_snapshot_Rcpp(SEXP repacker) {
+  Repacker& packer = repacker_from(repacker);
+  IntegerVector bin(packer.num_items()), size(packer.num_items()), loads(packer.num_slots());
+  for (int item = 0; item < packer.num_items(); item++) {
+    bin[item] = packer.contains(item) ? packer.bin_of(item) + 1 : NA_INTEGER;
+    size[item] = packer.size_of(item);
+  }
+  for (int b = 0; b < packer.num_slots(); b++) loads[b] = packer.load_of(b);
+  return List::create(Named("bin") = bin, Named("size") = size, Named("loads") = loads,
+                      Named("num_bins") = packer.num_bins());
+}
@@ -0,0 +1,292 @@
+#ifndef RESIDUAL_KERNELS_H
+#define RESIDUAL_KERNELS_H
+
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Search structures of the greedy packers specialised for small capacities,
+// the common case: they replace ResidualTree and ResidualSet (same
+// interface) when every residual fits in a narrow integer, see the
+// dispatch in greedyPacking.h.
+
+// Index of the lowest set bit of a non-zero word
+inline int lowest_bit(uint64_t mask) {
+#if defined(__GNUC__)
+  return __builtin_ctzll(mask);
+#else
+  int j = 0;
+  while (!(mask >> j & 1)) j++;
+  return j;
+#endif
+}
+
+// Largest capacities the uint8_t / uint16_t kernels take
+const int NARROW_CAPACITY = 255;
+const int MEDIUM_CAPACITY = 65535;
+
+// First fit over residuals of type T. Bins are grouped in blocks of BLOCK
+// contiguous residuals (one cache line for uint8_t), and a max segment tree
+// over the blocks, also of type T, finds the leftmost block holding a bin
+// with enough room; the block is then scanned with SIMD compares turned into
+// a bit mask, whose lowest bit is the bin. With uint8_t residuals, the tree
+// of a million bins takes 64 KB instead of 8 MB for ResidualTree.
+// Unopened bins hold 0 and size 0 items go to the first open bin.
+template <typename T>
+class BlockResiduals {
+public:
+  static const int BLOCK = 64;
+
+  explicit BlockResiduals(int expected_bins = 1) { reset(expected_bins); }
+
+  // Closes every bin, keeping the allocated storage when it is large enough
+  void reset(int expected_bins) {
+    num_bins = 0;
+    leaves = 1;
+    while (leaves * BLOCK < expected_bins) leaves <<= 1;
+    residuals.assign(leaves * BLOCK, 0);
+    tree.assign(2 * leaves, 0);
+  }
+
+  int size() const { return num_bins; }
+
+  int residual(int bin) const { return residuals[bin]; }
+
+  // Index of the leftmost open bin whose residual is at least `item`, -1 if none
+  int first_fit(int item) const {
+    if (num_bins == 0 || tree[1] < item) return -1;
+    if (item == 0) return 0;
+    int node = 1;
+    while (node < leaves) {
+      node <<= 1;
+      if (tree[node] < item) node++;
+    }
+    int block = node - leaves;
+    uint64_t fits = scan(residuals.data() + block * BLOCK, (T) item);
+    return block * BLOCK + lowest_bit(fits);
+  }
+
+  // Opens a new bin with the given residual and returns its index
+  int open_bin(int residual) {
+    if (num_bins == leaves * BLOCK) grow();
+    int bin = num_bins++;
+    set_residual(bin, residual);
+    return bin;
+  }
+
+  void set_residual(int bin, int residual) {
+    T old = residuals[bin];
+    residuals[bin] = (T) residual;
+    int node = leaves + bin / BLOCK;
+    // a residual going down only changes the block's max if it was the max
+    if (residual < old && old < tree[node]) return;
+    const T* r = residuals.data() + bin / BLOCK * BLOCK;
+    T best = 0;
+    for (int j = 0; j < BLOCK; j++) best = std::max(best, r[j]);
+    tree[node] = best;
+    for (node >>= 1; node >= 1; node >>= 1) {
+      T up = std::max(tree[2 * node], tree[2 * node + 1]);
+      if (tree[node] == up) break;
+      tree[node] = up;
+    }
+  }
+
+private:
+  int leaves; // blocks, a power of two
+  int num_bins;
+  std::vector<T> residuals;
+  std::vector<T> tree;
+
+  // Bit j set when r[j] >= need
+  static uint64_t scan(const T* r, T need) {
+    uint64_t mask = 0;
+    for (int j = 0; j < BLOCK; j++) mask |= (uint64_t) (r[j] >= need) << j;
+    return mask;
+  }
+
+  // Doubles the number of blocks, the old tree becomes the left subtree
+  void grow() {
+    residuals.resize(2 * residuals.size(), 0);
+    std::vector<T> old;
+    old.swap(tree);
+    leaves <<= 1;
+    tree.assign(2 * leaves, 0);
+    std::copy(old.begin() + leaves / 2, old.end(), tree.begin() + leaves);
+    for (int node = leaves - 1; node >= 1; node--) {
+      tree[node] = std::max(tree[2 * node], tree[2 * node + 1]);
+    }
+  }
+};
+
+// r >= need is max(r, need) == r for unsigned bytes, and need - r saturating
+// at 0 for unsigned words; the compare masks are packed to one bit per bin
+#if defined(__AVX2__)
+template <>
+inline uint64_t BlockResiduals<uint8_t>::scan(const uint8_t* r, uint8_t need) {
+  __m256i n = _mm256_set1_epi8((char) need);
+  __m256i a = _mm256_loadu_si256((const __m256i*) r);
+  __m256i b = _mm256_loadu_si256((const __m256i*) (r + 32));
+  uint32_t lo = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(a, n), a));
+  uint32_t hi = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(b, n), b));
+  return (uint64_t) lo | (uint64_t) hi << 32;
+}
+
+template <>
+inline uint64_t BlockResiduals<uint16_t>::scan(const uint16_t* r, uint16_t need) {
+  __m256i n = _mm256_set1_epi16((short) need), zero = _mm256_setzero_si256();
+  uint64_t mask = 0;
+  for (int k = 0; k < 2; k++) {
+    __m256i a = _mm256_loadu_si256((const __m256i*) (r + 32 * k));
+    __m256i b = _mm256_loadu_si256((const __m256i*) (r + 32 * k + 16));
+    __m256i fa = _mm256_cmpeq_epi16(_mm256_subs_epu16(n, a), zero);
+    __m256i fb = _mm256_cmpeq_epi16(_mm256_subs_epu16(n, b), zero);
+    // packs works within 128-bit lanes, the permute puts the bins back in order
+    __m256i bytes = _mm256_permute4x64_epi64(_mm256_packs_epi16(fa, fb), 0xD8);
+    mask |= (uint64_t) (uint32_t) _mm256_movemask_epi8(bytes) << (32 * k);
+  }
+  return mask;
+}
+#elif defined(__SSE2__)
+template <>
+inline uint64_t BlockResiduals<uint8_t>::scan(const uint8_t* r, uint8_t need) {
+  __m128i n = _mm_set1_epi8((char) need);
+  uint64_t mask = 0;
+  for (int k = 0; k < 4; k++) {
+    __m128i a = _mm_loadu_si128((const __m128i*) (r + 16 * k));
+    mask |= (uint64_t) (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(a, n), a)) << (16 * k);
+  }
+  return mask;
+}
+
+template <>
+inline uint64_t BlockResiduals<uint16_t>::scan(const uint16_t* r, uint16_t need) {
+  __m128i n = _mm_set1_epi16((short) need), zero = _mm_setzero_si128();
+  uint64_t mask = 0;
+  for (int k = 0; k < 4; k++) {
+    __m128i a = _mm_loadu_si128((const __m128i*) (r + 16 * k));
+    __m128i b = _mm_loadu_si128((const __m128i*) (r + 16 * k + 8));
+    __m128i fa = _mm_cmpeq_epi16(_mm_subs_epu16(n, a), zero);
+    __m128i fb = _mm_cmpeq_epi16(_mm_subs_epu16(n, b), zero);
+    mask |= (uint64_t) (uint32_t) _mm_movemask_epi8(_mm_packs_epi16(fa, fb)) << (16 * k);
+  }
+  return mask;
+}
+#endif
+
+// Best fit for capacities up to MEDIUM_CAPACITY: the open bins are bucketed
+// by residual, and a bitset over the residual values, with a summary word
+// per 64 words, marks the non-empty buckets. The tightest bin able to take an
+// item is in the first non-empty bucket from the item's size on, found with
+// a few word operations instead of a walk down a balanced tree. Every bucket
+// is a min-heap of bins, so ties go to the bin opened first, as with
+// ResidualSet. Residuals may only go down (the greedy packers only add
+// items): a bin leaving a bucket stays in its heap and is dropped when it
+// comes to the top.
+class ResidualBuckets {
+public:
+  ResidualBuckets() : capacity(-1) {}
+
+  // Empties the buckets, for bins of the given capacity. The storage only
+  // grows, to the largest capacity seen, and only the buckets used are
+  // cleared, so that instances of varying capacities cost O(their bins).
+  void reset(int new_capacity) {
+    clear();
+    capacity = new_capacity;
+    if (capacity + 1 > (int) count.size()) {
+      bits.resize(capacity / 64 + 1, 0);
+      summary.resize(bits.size() / 64 + 1, 0);
+      heaps.resize(capacity + 1);
+      count.resize(capacity + 1, 0);
+    }
+  }
+
+  void clear() {
+    for (int r : touched) {
+      heaps[r].clear();
+      count[r] = 0;
+      bits[r / 64] = 0;
+      summary[r / 4096] = 0;
+    }
+    touched.clear();
+    residual_of.clear();
+  }
+
+  // Index of the open bin with the smallest residual still >= `item`, -1 if none
+  int best_fit(int item) {
+    int r = next_bucket(item);
+    if (r < 0) return -1;
+    std::vector<int>& heap = heaps[r];
+    while (residual_of[heap.front()] != r) {
+      std::pop_heap(heap.begin(), heap.end(), std::greater<int>());
+      heap.pop_back();
+    }
+    return heap.front();
+  }
+
+  void add_bin(int bin, int residual) {
+    if (bin >= (int) residual_of.size()) residual_of.resize(bin + 1, -1);
+    enter(bin, residual);
+  }
+
+  void update(int bin, int old_residual, int new_residual) {
+    if (new_residual == old_residual) return;
+    if (--count[old_residual] == 0) {
+      bits[old_residual / 64] &= ~((uint64_t) 1 << (old_residual % 64));
+      if (bits[old_residual / 64] == 0) {
+        summary[old_residual / 4096] &= ~((uint64_t) 1 << (old_residual / 64 % 64));
+      }
+    }
+    enter(bin, new_residual);
+  }
+
+private:
+  int capacity;
+  std::vector<uint64_t> bits;    // bit r: some open bin has residual r
+  std::vector<uint64_t> summary; // bit w: word w of bits is not zero
+  std::vector<std::vector<int>> heaps;
+  std::vector<int> count;        // open bins of every residual
+  std::vector<int> residual_of;  // residual of every bin
+  std::vector<int> touched;      // buckets used since the last clear()
+
+  void enter(int bin, int residual) {
+    residual_of[bin] = residual;
+    std::vector<int>& heap = heaps[residual];
+    if (heap.empty() && count[residual] == 0) touched.push_back(residual);
+    heap.push_back(bin);
+    std::push_heap(heap.begin(), heap.end(), std::greater<int>());
+    if (count[residual]++ == 0) {
+      bits[residual / 64] |= (uint64_t) 1 << (residual % 64);
+      summary[residual / 4096] |= (uint64_t) 1 << (residual / 64 % 64);
+    }
+  }
+
+
+  // Smallest non-empty residual >= from, -1 if none
+  int next_bucket(int from) const {
+    if (from > capacity) return -1;
+    int word = from / 64;
+    uint64_t here = bits[word] & (~(uint64_t) 0 << (from % 64));
+    if (here) return word * 64 + lowest_bit(here);
+    // next non-zero word, from the summary
+    int next = word + 1;
+    int last = capacity / 4096; // summary word of the largest residual
+    for (int s = next / 64; s <= last; s++) {
+      uint64_t words = summary[s];
+      if (s == next / 64) words &= ~(uint64_t) 0 << (next % 64);
+      if (words) {
+        int w = s * 64 + lowest_bit(words);
+        return w * 64 + lowest_bit(bits[w]);
+      }
+    }
+    return -1;
+  }
+};
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef RESIDUAL_SET_H
+#define RESIDUAL_SET_H
+
+#include <set>
+#include <utility>
+
+// Open bins ordered by residual capacity (balanced tree), used for best-fit.
+// The tightest bin able to take an item is the first (residual, bin) pair not
+// smaller than (item, -1): O(log n) per query and per update. Ties between
+// bins with the same residual go to the bin opened first.
+class ResidualSet {
+public:
+  // Index of the open bin with the smallest residual still >= `item`, -1 if none
+  int best_fit(int item) const {
+    auto it = order.lower_bound(std::make_pair(item, -1));
+    return it == order.end() ? -1 : it->second;
+  }
+
+  void clear() { order.clear(); }
+
+  void add_bin(int bin, int residual) {
+    order.insert(std::make_pair(residual, bin));
+  }
+
+  void remove_bin(int bin, int residual) {
+    order.erase(std::make_pair(residual, bin));
+  }
+
+  void update(int bin, int old_residual, int new_residual) {
+    order.erase(std::make_pair(old_residual, bin));
+    order.insert(std::make_pair(new_residual, bin));
+  }
+
+private:
+  std::set<std::pair<int, int>> order;
+};
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef RESIDUAL_TREE_H
+#define RESIDUAL_TREE_H
+
+#include <vector>
+#include <algorithm>
+
+// Max segment tree over the residual capacities of the open bins.
+// Leaves are the bins in opening order, every internal node keeps the largest
+// residual of its subtree, so the leftmost bin able to take an item is found
+// by a single descent from the root: O(log n) per query and per update.
+// Unopened leaves hold -1 and can never satisfy a query, even for size 0 items.
+class ResidualTree {
+public:
+  explicit ResidualTree(int expected_bins = 1) {
+    reset(expected_bins);
+  }
+
+  // Closes every bin, keeping the allocated storage when it is large enough
+  void reset(int expected_bins) {
+    leaves = 1;
+    num_bins = 0;
+    while (leaves < expected_bins) leaves <<= 1;
+    tree.assign(2 * leaves, -1);
+  }
+
+  // Number of bins opened so far
+  int size() const { return num_bins; }
+
+  int residual(int bin) const { return tree[leaves + bin]; }
+
+  // Index of the leftmost open bin whose residual is at least `item`, -1 if none
+  int first_fit(int item) const {
+    if (tree[1] < item) return -1;
+    int node = 1;
+    while (node < leaves) {
+      node <<= 1;
+      if (tree[node] < item) node++;
+    }
+    return node - leaves;
+  }
+
+  // Opens a new bin with the given residual and returns its index
+  int open_bin(int residual) {
+    if (num_bins == leaves) grow();
+    int bin = num_bins++;
+    set_residual(bin, residual);
+    return bin;
+  }
+
+  void set_residual(int bin, int residual) {
+    int node = leaves + bin;
+    tree[node] = residual;
+    for (node >>= 1; node >= 1; node >>= 1) {
+      int best = std::max(tree[2 * node], tree[2 * node + 1]);
+      if (tree[node] == best) break;
+      tree[node] = best;
+    }
+  }
+
+private:
+  int leaves;
+  int num_bins;
+  std::vector<int> tree;
+
+  // Doubles the number of leaves, the old tree becomes the left subtree
+  void grow() {
+    std::vector<int> old;
+    old.swap(tree);
+    leaves <<= 1;
+    tree.assign(2 * leaves, -1);
+    std::copy(old.begin() + leaves / 2, old.end(), tree.begin() + leaves);
+    for (int node = leaves - 1; node >= 1; node--) {
+      tree[node] = std::max(tree[2 * node], tree[2 * node + 1]);
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,160 @@
+#ifndef SCRATCH_ARENA_H
+#define SCRATCH_ARENA_H
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <cstddef>
+#include <type_traits>
+#include <algorithm>
+
+// Monotonic scratch memory for the engines. Allocations bump a pointer in the
+// current chunk and are never freed one by one; reset() forgets them all at
+// once. A reset arena whose allocations overflowed into several chunks
+// replaces them with a single chunk as large as all of them, so that a call
+// of the same size as the previous one allocates nothing from the heap.
+class ScratchArena {
+public:
+  static const std::size_t FIRST_CHUNK = 1 << 16;
+
+  ScratchArena() : current(0), used(0) {}
+
+  ScratchArena(const ScratchArena&) = delete;
+  ScratchArena& operator=(const ScratchArena&) = delete;
+
+  void* allocate(std::size_t bytes, std::size_t align) {
+    while (current < chunks.size()) {
+      std::size_t start = (used + align - 1) / align * align;
+      if (start + bytes <= sizes[current]) {
+        used = start + bytes;
+        return chunks[current].get() + start;
+      }
+      current++;
+      used = 0;
+    }
+    std::size_t size = 2 * capacity(); // chunks double
+    if (size < FIRST_CHUNK) size = FIRST_CHUNK;
+    if (size < bytes + align) size = bytes + align;
+    chunks.emplace_back(new char[size]);
+    sizes.push_back(size);
+    used = 0;
+    return allocate(bytes, align);
+  }
+
+  template <typename T>
+  T* allocate(std::size_t count) {
+    return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+  }
+
+  void reset() {
+    if (chunks.size() > 1) {
+      std::size_t total = capacity();
+      chunks.clear();
+      sizes.clear();
+      chunks.emplace_back(new char[total]);
+      sizes.push_back(total);
+    }
+    current = 0;
+    used = 0;
+  }
+
+  std::size_t capacity() const {
+    std::size_t total = 0;
+    for (std::size_t size : sizes) total += size;
+    return total;
+  }
+
+private:
+  std::vector<std::unique_ptr<char[]>> chunks;
+  std::vector<std::size_t> sizes;
+  std::size_t current; // chunk being filled
+  std::size_t used;    // bytes taken in it
+};
+
+// Standard allocator drawing from an arena; deallocation is a no-op, the
+// memory comes back with the arena's reset(). Containers moved or swapped
+// take their arena along.
+template <typename T>
+struct ArenaAllocator {
+  typedef T value_type;
+  typedef std::true_type propagate_on_container_move_assignment;
+  typedef std::true_type propagate_on_container_swap;
+
+  ScratchArena* arena;
+
+  ArenaAllocator() : arena(nullptr) {}
+  explicit ArenaAllocator(ScratchArena& arena) : arena(&arena) {}
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+  T* allocate(std::size_t count) { return arena->allocate<T>(count); }
+  void deallocate(T*, std::size_t) {}
+
+  template <typename U>
+  bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+  template <typename U>
+  bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.arena; }
+};
+
+template <typename T>
+using ScratchVector = std::vector<T, ArenaAllocator<T>>;
+
+// Arenas outlive the calls: a solver leases one per worker thread and hands
+// it back, reset, when it is done, for the next call to reuse its chunks.
+// The pool keeps at most MAX_IDLE arenas of at most MAX_RETAINED bytes each;
+// the others are freed when handed back, so that a call much larger than
+// the usual ones, or a burst of concurrent calls, does not hold on to its
+// memory for the rest of the session.
+class ArenaPool {
+public:
+  static const std::size_t MAX_IDLE = 64;
+  static const std::size_t MAX_RETAINED = (std::size_t) 1 << 26;
+
+  static ArenaPool& shared() {
+    static ArenaPool pool;
+    return pool;
+  }
+
+  std::unique_ptr<ScratchArena> acquire() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (idle.empty()) return std::unique_ptr<ScratchArena>(new ScratchArena());
+    std::unique_ptr<ScratchArena> arena = std::move(idle.back());
+    idle.pop_back();
+    return arena;
+  }
+
+  void release(std::unique_ptr<ScratchArena> arena) {
+    if (arena->capacity() > MAX_RETAINED) return;
+    arena->reset();
+    std::lock_guard<std::mutex> lock(mutex);
+    if (idle.size() < MAX_IDLE) idle.push_back(std::move(arena));
+  }
+
+  // Arenas waiting to be reused
+  std::size_t size() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return idle.size();
+  }
+
+private:
+  std::mutex mutex;
+  std::vector<std::unique_ptr<ScratchArena>> idle;
+};
+
+// Arena leased from the shared pool for the lifetime of the object
+class ArenaLease {
+public:
+  ArenaLease() : arena(ArenaPool::shared().acquire()) {}
+  ~ArenaLease() {
+    if (arena) ArenaPool::shared().release(std::move(arena));
+  }
+  ArenaLease(ArenaLease&& other) = default;
+  ArenaLease& operator=(ArenaLease&&) = delete;
+
+  ScratchArena& operator*() const { return *arena; }
+
+private:
+  std::unique_ptr<ScratchArena> arena;
+};
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef SEARCH_BUDGET_H
+#define SEARCH_BUDGET_H
+
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <functional>
+
+// Snapshot of a running search, handed to the progress hook
+struct SearchProgress {
+  long long nodes;  // nodes (or permutations, subsets) explored so far
+  double elapsed;   // seconds since the search started
+  int num_bins;     // bins of the best packing found so far
+  int lower_bound;
+};
+
+// Wall-clock and node budget of a search, shared by all its threads.
+// Searches charge their nodes by blocks of CHECK_NODES, which is also when
+// the clock is read, so the budget may be overrun by a block per thread.
+// The caller can hook an interrupt check (which stops the search by
+// throwing) and a progress report; both only run on the thread calling
+// poll(), at most every progress_interval seconds for the report. An
+// exception thrown by a hook stops the search and is raised again by
+// rethrow() once every worker is done, so the hooks may call the R API as
+// long as poll() is called from the R thread.
+class SearchBudget {
+public:
+  static const int CHECK_NODES = 1024;
+
+  std::function<void()> check;
+  std::function<void(const SearchProgress&)> progress;
+  double progress_interval = 1;
+
+  // time_limit in seconds and max_nodes, 0 for no limit
+  explicit SearchBudget(double time_limit = 0, long long max_nodes = 0)
+    : time_limit(time_limit), max_nodes(max_nodes),
+      start(std::chrono::steady_clock::now()), last_report(0) {}
+
+  // Charges explored nodes and looks at the clock, from any thread;
+  // false once the search has to stop
+  bool spend(long long nodes) {
+    long long total = spent.fetch_add(nodes) + nodes;
+    if ((max_nodes > 0 && total >= max_nodes) || (time_limit > 0 && elapsed() >= time_limit)) {
+      stopped.store(true);
+    }
+    return !exhausted();
+  }
+
+  // To be called at every node with the thread's own node counter: charges
+  // the nodes by blocks and, on the caller's thread, runs the hooks
+  bool tick(long long& nodes, bool caller_thread, int num_bins, int lower_bound) {
+    if (++nodes % CHECK_NODES != 0) return !exhausted();
+    if (!spend(CHECK_NODES)) return false;
+    if (caller_thread) poll(num_bins, lower_bound);
+    return !exhausted();
+  }
+
+  // Runs the interrupt check and, when it is due, the progress report.
+  // Caller's thread only.
+  void poll(int num_bins, int lower_bound) {
+    try {
+      if (check) check();
+      double now = elapsed();
+      if (progress && now - last_report >= progress_interval) {
+        last_report = now;
+        progress(SearchProgress{spent.load(), now, num_bins, lower_bound});
+      }
+    } catch (...) {
+      error = std::current_exception();
+      stopped.store(true);
+    }
+  }
+
+  // Stops the search, from any thread
+  void stop() { stopped.store(true); }
+
+  // True once the time or node budget is spent, a hook threw, or stop()
+  // was called
+  bool exhausted() const { return stopped.load(std::memory_order_relaxed); }
+
+  // Raises the exception a hook threw, if any
+  void rethrow() const {
+    if (error) std::rethrow_exception(error);
+  }
+
+  double elapsed() const {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+
+private:
+  double time_limit;
+  long long max_nodes;
+  std::chrono::steady_clock::time_point start;
+  double last_report;
+  std::atomic<long long> spent{0};
+  std::atomic<bool> stopped{false};
+  std::exception_ptr error;
+};
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef SEARCH_STATS_H
+#define SEARCH_STATS_H
+
+#include <vector>
+#include <chrono>
+#include <mutex>
+
+// Counters of a search. Every thread keeps its own, incremented without any
+// synchronisation, and they are merged once the search is over.
+struct SearchCounters {
+  long long nodes = 0;
+  long long pruned_bound = 0;     // nodes cut by the lower bound
+  long long pruned_symmetry = 0;  // branches skipped as equivalent to one tried
+  long long pruned_incumbent = 0; // new bins not opened, the incumbent being as good
+  long long improvements = 0;     // times the incumbent improved
+
+  void merge(const SearchCounters& other) {
+    nodes += other.nodes;
+    pruned_bound += other.pruned_bound;
+    pruned_symmetry += other.pruned_symmetry;
+    pruned_incumbent += other.pruned_incumbent;
+    improvements += other.improvements;
+  }
+};
+
+// Incumbent improvement, recorded when tracing
+struct TracePoint {
+  double elapsed;
+  long long nodes;
+  int num_bins;
+};
+
+// Statistics of one call, handed back to R with its result: the merged
+// counters, the time spent in each phase (reading and sorting the input,
+// searching, building the R result), measured with lap(), and, when
+// tracing, every improvement of the incumbent. Engines are given a pointer
+// to it; with none they only keep their own counters.
+class SearchStats {
+public:
+  SearchCounters counters;
+  double setup_seconds = 0;
+  double search_seconds = 0;
+  double marshal_seconds = 0;
+  std::vector<TracePoint> trace;
+
+  explicit SearchStats(bool tracing = false)
+    : tracing(tracing), start(std::chrono::steady_clock::now()), last_lap(start) {}
+
+  // Adds the time since the previous lap (or the creation) to `phase`
+  void lap(double& phase) {
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    phase += std::chrono::duration<double>(now - last_lap).count();
+    last_lap = now;
+  }
+
+  // Adds the counters of a thread once it is done, from any thread
+  void merge(const SearchCounters& thread_counters) {
+    std::lock_guard<std::mutex> lock(mutex);
+    counters.merge(thread_counters);
+  }
+
+  bool tracing_enabled() const { return tracing; }
+
+  // Records an improvement of the incumbent, from any thread
+  void improved(long long nodes, int num_bins) {
+    if (!tracing) return;
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::lock_guard<std::mutex> lock(mutex);
+    trace.push_back(TracePoint{elapsed, nodes, num_bins});
+  }
+
+private:
+  bool tracing;
+  std::chrono::steady_clock::time_point start;
+  std::chrono::steady_clock::time_point last_lap;
+  std::mutex mutex;
+};
+
+#endif
@@ -10,215 +10,209 @@ using namespace std;
 #include <limits>
 #include <numeric>
 
-#include <cmath>
-
-
-std::vector<std::vector<int>> generate_permutations(std::vector<int> elements) {
-  if (elements.size() <= 1) {
-    return {elements};
-  } else {
-    std::vector<std::vector<int>> perms;
-    for (int i = 0; i < elements.size(); i++) {
-      int current_element = elements[i];
-      vector<int> remaining_elements;
-      remaining_elements.reserve(elements.size() - 1);
-      for (int j = 0; j < elements.size(); j++) {
-        if (j != i) {
-          remaining_elements.push_back(elements[j]);
-        }
-      }
-      auto sub_perms = generate_permutations(remaining_elements);
-      for (auto perm : sub_perms) {
-        perm.insert(perm.begin(), current_element);
-        perms.push_back(perm);
-      }
-    }
-    return perms;
-  }
+#include "packingState.h"
+#include "branchAndBound.h"
+#include "lowerBounds.h"
+#include "reduction.h"
+#include "searchBudget.h"
+#include "rInterface.h"
+#include "indexSort.h"
+
+
+//' Lower bounds on the number of storages
+//'
+//' L1 is ceiling(sum / mem). L2 is the Martello-Toth bound, which also counts
+//' the games too large to share a storage with each other; it is never below
+//' L1 and is computed in O(n) once the sizes are sorted. L3 adds the storages
+//' fixed by the Martello-Toth reduction to L2 of the games it leaves.
+//' @param j a vector of games' sizes
+//' @param mem an integer corresponding to the memory size
+//' @return a named integer vector with the bounds L1, L2 and L3
+//' @export
+// [[Rcpp::export]]
+IntegerVector storage_lower_bounds(SEXP j, int mem) {
+  SortedInput input(j, mem);
+  const std::vector<int>& sorted = input.sizes;
+  return IntegerVector::create(Named("L1") = lower_bound_l1(sorted.data(), sorted.size(), mem),
+                               Named("L2") = lower_bound_l2(sorted, mem),
+                               Named("L3") = lower_bound_l3(sorted, mem));
 }
 
 
 
-//' Insertion sort algorithm using C++
+//' Naive storage optimisation using C++
 //'
+//' Tries every distinct order of the games, packs each one first-fit and
+//' keeps the order using the fewest storages. Orders are enumerated in place
+//' with std::next_permutation over the sorted sizes, so games of equal size
+//' are not permuted among themselves and memory stays O(n). The search stops
+//' as soon as an order reaches the L2 lower bound, or when
+//' the time or permutation budget is spent, in which case the best packing
+//' found so far is returned. The search can be interrupted from R.
 //' @param j an unsorted vector of numeric data
 //' @param mem an integer corresponding to the memory size
-//' @return a sorted vector
+//' @param time_limit maximal running time in seconds, 0 for no limit
+//' @param max_permutations maximal number of orders to try, 0 for no limit
+//' @param progress an optional function, called about once per second with a
+//'        list (nodes, elapsed, num_bins, lower_bound) describing the search
+//' @return A list of vectors representing the storages, where each inner
+//'         vector contains the sizes of the games stored in it, with the
+//'         attributes \code{lower_bound}, \code{gap} (storages above the
+//'         lower bound), \code{optimal}, \code{assignment} (the storage
+//'         of every game, in input order, numbered from 1) and \code{stats}
+//'         (orders tried as nodes, improvements, seconds per phase and, with
+//'         \code{options(StorageOptimisation.trace = TRUE)}, the trace of the
+//'         improvements).
 //' @export
 // [[Rcpp::export]] //mandatory to export the function
-std::vector<std::vector<int>> naive_storage_Rcpp(std::vector<int> j, int mem) {
-  std::vector<std::vector<int>> permutations = generate_permutations(j);
+List naive_storage_Rcpp(SEXP j, int mem, double time_limit = 0, double max_permutations = 0,
+                        Nullable<Function> progress = R_NilValue) {
+  SearchStats stats(trace_requested());
+  SortedInput input(j, mem); // tailles décroissantes et leur position dans l'entrée
+  int n = input.sizes.size();
+  SearchBudget budget(time_limit);
+  connect_budget(budget, progress);
+  int borne = lower_bound_l2(input.sizes, mem);
+  SearchCounters compteurs;
 
   int memoire_minimale = numeric_limits<int>::max();
-  std::vector<std::vector<int>> best_bins;
+  PackingState state(mem, n); // Mémoires réutilisées d'une permutation à l'autre
+  PackingState best_state(mem, n);
+  std::vector<int> best_permutation;
 
-  for (const auto& permutation : permutations) {
-    std::vector<int> memoires(j.size(), mem); // Initialise toutes les mémoires avec la même taille
-    int nombre_memoires = 0;
-    std::vector<vector<int>> bins(j.size());
+  // première permutation : l'ordre croissant
+  std::vector<int> permutation(input.sizes.rbegin(), input.sizes.rend());
+  stats.lap(stats.setup_seconds);
+  long long essais = 0;
+  bool complet = true; // toutes les permutations ont été essayées
+
+  do {
+    state.reset(permutation.size());
 
     for (int i = 0; i < permutation.size(); i++) {
       int jeu = permutation[i];
-      bool fitted = false;
-      for (int k = 0; k < bins.size(); k++) {
-        if (accumulate(bins[k].begin(), bins[k].end(), 0) + jeu <= mem) {
-          bins[k].push_back(jeu);
-          memoires[k] -= jeu;
-          fitted = true;
-          break;
+      int k = 0;
+      while (k < state.num_bins() && !state.fits(k, jeu)) k++;
+      if (k == state.num_bins()) {
+        state.open_bin();
       }
+      state.place(i, k, jeu);
     }
-      if (!fitted) {
-        bins[nombre_memoires].push_back(jeu);
-        memoires[nombre_memoires] -= jeu;
-        nombre_memoires++;
-    }
-  }
 
-    nombre_memoires = count_if(memoires.begin(), memoires.end(), [mem](int m) { return m < mem; });
+    int nombre_memoires = count_if(state.load.begin(), state.load.end(), [](int l) { return l > 0; });
 
     if (nombre_memoires < memoire_minimale) {
       memoire_minimale = nombre_memoires;
-      best_bins = bins;
+      best_state = state;
+      best_permutation = permutation;
+      compteurs.improvements++;
+      stats.improved(essais, memoire_minimale);
+      if (memoire_minimale <= borne) break;
     }
-  }
-
-  best_bins.erase(remove_if(best_bins.begin(), best_bins.end(), [](const vector<int>& v) { return v.empty(); }), best_bins.end());
 
-  return best_bins;
+    if (!budget.tick(essais, true, memoire_minimale, borne) ||
+        (max_permutations > 0 && essais >= max_permutations)) {
+      complet = false;
+      break;
+    }
+  } while (next_permutation(permutation.begin(), permutation.end()));
+  budget.rethrow();
+  compteurs.nodes = essais;
+  stats.merge(compteurs);
+  stats.lap(stats.search_seconds);
+
+  // Jeux de même taille interchangeables : le k-ième plus grand jeu de
+  // l'entrée prend la place du k-ième plus grand de la meilleure permutation
+  IndexSorter tri;
+  std::vector<int> ordre_permutation;
+  tri.sort(best_permutation.data(), best_permutation.size(), ordre_permutation);
+  std::vector<int> affectation(n);
+  for (int k = 0; k < n; k++) affectation[k] = best_state.assignment[ordre_permutation[k]];
+
+  List result = bins_list(best_state, best_permutation);
+  set_search_attributes(result, memoire_minimale, borne, complet || memoire_minimale <= borne);
+  result.attr("assignment") = input_assignment(affectation, input.input_index);
+  set_stats(result, stats);
+  return result;
 }
 
 
 
 std::vector<std::vector<int>> bfd(const std::vector<int>& items, int m) {
   int n = items.size();
-  std::vector<std::vector<int>> bins; // Stores items in each bin
+  PackingState state(m, n); // Loads of the bins and bin of each item
 
   for (int i = 0; i < n; ++i) {
     int best_bin = -1;
-    int best_fit = std::numeric_limits<int>::max(); // Initialize with positive infinity
+    int best_fit = -1; // Load of the fullest bin that can take the item
 
     // Find the best fitting bin for the current item
-    for (size_t j = 0; j < bins.size(); ++j) {
-      int current_sum = std::accumulate(bins[j].begin(), bins[j].end(), 0);
-      if (items[i] <= m - current_sum && current_sum < best_fit) {
-        best_fit = current_sum;
+    for (int j = 0; j < state.num_bins(); ++j) {
+      if (state.fits(j, items[i]) && state.load[j] > best_fit) {
+        best_fit = state.load[j];
         best_bin = j;
       }
     }
 
     // If no bin can fit the item, create a new bin
     if (best_bin == -1) {
-      bins.push_back(std::vector<int>{items[i]});
-    } else {
-      // Add the item to the best fitting bin
-      bins[best_bin].push_back(items[i]);
+      best_bin = state.open_bin();
     }
+    state.place(i, best_bin, items[i]);
   }
 
-  return bins;
+  return state.bins(items);
 }
 
 
-// Function to calculate a lower bound (replace with your actual implementation)
-int lower_bound(const std::vector<int>& items, int bin_size) {
-  int sum = 0;
-  for (int item : items) {
-    sum += item;
-  }
-  return std::ceil(static_cast<double>(sum) / bin_size);
-}
 
 
 
 
- // Taille maximale d'un objet
-#define MAX_SIZE 100
-
- int n; // nombre d'objets
- vector<int> sizes; // tableau des tailles des objets
- vector<int> bins; // tableau des tailles des bacs
- vector<int> best_bins; // meilleure solution trouvée
- int best_num_bins; // nombre de bacs dans la meilleure solution
-
- // Trie les objets par taille décroissante
- void sort_items() {
-   sort(sizes.begin(), sizes.end(), greater<int>());
- }
-
- // Vérifie si un objet peut être ajouté à un bac
- bool can_add_item(int bin, int item) {
-   return bins[bin] + sizes[item] <= MAX_SIZE;
- }
-
- // Ajoute un objet à un bac
- void add_item(int bin, int item) {
-   bins[bin] += sizes[item];
- }
-
- // Supprime un objet d'un bac
- void remove_item(int bin, int item) {
-   bins[bin] -= sizes[item];
- }
-
- // Recherche la meilleure solution en utilisant l'algorithme de Branch and Bound
- void branch_and_bound(int item, int num_bins, int max_size) {
-   // Cas de base : tous les objets ont été affectés à un bac
-   if (item == n) {
-     // Mise à jour de la meilleure solution
-     if (num_bins < best_num_bins) {
-       best_num_bins = num_bins;
-       best_bins.assign(bins.begin(), bins.begin() + num_bins);
-     }
-     return;
-   }
-
-   // Bornes inférieure et supérieure pour le nombre de bacs nécessaires
-   int lower_bound = num_bins;
-   int upper_bound = best_num_bins;
-   int total_size = 0;
-   for (int i = item; i < n; i++) {
-     total_size += sizes[i];
-     upper_bound = max(upper_bound, (total_size + max_size - 1) / max_size);
-   }
-
-   // Vérification de la borne supérieure
-   if (lower_bound >= upper_bound) return;
-
-   // Affectation de l'objet courant au premier bac possible
-   for (int bin = 0; bin < num_bins; bin++) {
-     if (can_add_item(bin, item)) {
-       add_item(bin, item);
-       branch_and_bound(item + 1, num_bins, max_size);
-       remove_item(bin, item);
-       return;
-     }
-   }
-
-   // Ajout d'un nouveau bac et affectation de l'objet courant à ce bac
-   if (num_bins < best_num_bins) {
-     bins[num_bins] = sizes[item];
-     branch_and_bound(item + 1, num_bins + 1, max_size);
-     bins[num_bins] = 0;
-   }
- }
-
- //' Insertion sort algorithm using C++
- //'
- //' @param jeux an unsorted vector of numeric data
- //' @param m an integer corresponding to the memory size
- //' @return a sorted vector
- //' @export
- // [[Rcpp::export]] //mandatory to export the function
- std::vector<int> solve_bin_packing(std::vector<int> c, int max_bin_size) {
-   n = c.size();
-   sizes.assign(c.begin(), c.end());
-   bins.assign(n, 0);
-   best_bins.clear();
-   best_num_bins = numeric_limits<int>::max();
-   int max_size = max_bin_size;
-   sort_items();
-   branch_and_bound(0, 0, max_size);
-   return best_bins;
- }
-
+//' Branch and bound algorithm using C++
+//'
+//' Explores the games by decreasing size with a depth-first branch and bound:
+//' each game is tried in every storage it fits in, then in a new one, except
+//' that storages with equal loads and games of equal size are not tried
+//' twice, and nodes are pruned with the Martello-Toth L2 bound. The search
+//' state belongs to a solver local to the call, so independent instances can
+//' be solved concurrently, with any storage size. It starts from the
+//' first-fit decreasing packing and can be stopped by a time or node budget,
+//' or interrupted from R; a search that runs to the end proves its packing
+//' optimal.
+//' @param c an unsorted vector of games' sizes
+//' @param max_bin_size an integer corresponding to the memory size
+//' @param time_limit maximal running time in seconds, 0 for no limit
+//' @param max_nodes maximal number of search nodes, 0 for no limit
+//' @param progress an optional function, called about once per second with a
+//'        list (nodes, elapsed, num_bins, lower_bound) describing the search
+//' @return the loads of the storages used by the best solution found, with
+//'         the attributes \code{lower_bound}, \code{gap} (storages above the
+//'         lower bound), \code{optimal}, \code{assignment} (the storage
+//'         of every game, in input order, numbered from 1) and \code{stats}
+//'         (nodes, pruned nodes, improvements, seconds per phase and, with
+//'         \code{options(StorageOptimisation.trace = TRUE)}, the trace of the
+//'         improvements)
+//' @export
+// [[Rcpp::export]] //mandatory to export the function
+IntegerVector solve_bin_packing(SEXP c, int max_bin_size, double time_limit = 0, double max_nodes = 0,
+                                Nullable<Function> progress = R_NilValue) {
+  SearchStats stats(trace_requested());
+  IntegerInput input(c);
+  check_sizes(input.data(), input.size(), max_bin_size);
+  SearchBudget budget(time_limit, (long long) max_nodes);
+  connect_budget(budget, progress);
+
+  BranchAndBoundSolver solver(input.data(), input.size(), max_bin_size);
+  solver.collect_stats(&stats);
+  stats.lap(stats.setup_seconds);
+  std::vector<int> loads = solver.solve(budget);
+  budget.rethrow();
+  stats.lap(stats.search_seconds);
+
+  IntegerVector result(loads.begin(), loads.end());
+  set_search_attributes(result, solver.num_bins(), solver.lower_bound(), solver.optimal());
+  result.attr("assignment") = input_assignment(solver.assignment(), solver.sorted_items());
+  set_stats(result, stats);
+  return result;
+}
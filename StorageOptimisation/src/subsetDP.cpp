@@ -0,0 +1,165 @@
+#include <Rcpp.h>
+using namespace Rcpp;
+using namespace std;
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+#include "packingState.h"
+#include "greedyPacking.h"
+#include "lowerBounds.h"
+#include "searchBudget.h"
+#include "rInterface.h"
+#include "indexSort.h"
+
+// Largest instance the subset DP is run on: its tables take 5 * 2^n bytes,
+// 40 MB for 23 games. Larger ones get the first-fit decreasing packing
+// without allocating them.
+#define MAX_DP_ITEMS 23
+
+// Bins of the packing with the search attributes and, in input order, the
+// storage of every game and the statistics of the call; entree[k] is the
+// input position of the game k
+static List dp_result(const PackingState& state, const std::vector<int>& j,
+                      const std::vector<int>& entree, int borne, bool optimal,
+                      SearchStats& stats) {
+  stats.lap(stats.search_seconds);
+  List result = bins_list(state, j);
+  set_search_attributes(result, state.num_bins(), borne, optimal);
+  result.attr("assignment") = input_assignment(state.assignment, entree);
+  set_stats(result, stats);
+  return result;
+}
+
+//' Exact storage optimisation by dynamic programming over subsets
+//'
+//' Gives the same optimal number of storages as \code{naive_storage_Rcpp}
+//' without enumerating the n! permutations. For every subset of games the
+//' DP keeps the best (storages used, load of the last storage) pair reachable
+//' by packing that subset first, which takes O(2^n * n) time and 5 * 2^n bytes.
+//' Games of equal size are interchangeable, so only the first unused copy of a
+//' size is tried. Beyond 23 games the tables would not fit in memory, and,
+//' as when the time limit is reached or the user interrupts it, the
+//' first-fit decreasing packing is returned instead.
+//' @param j a vector of games' sizes
+//' @param mem an integer corresponding to the memory size
+//' @param time_limit maximal running time in seconds, 0 for no limit
+//' @param progress an optional function, called about once per second with a
+//'        list (nodes, elapsed, num_bins, lower_bound) describing the search,
+//'        nodes being the subsets processed
+//' @return A list of vectors representing the storages, where each inner
+//'         vector contains the sizes of the games stored in it, with the
+//'         attributes \code{lower_bound}, \code{gap} (storages above the
+//'         lower bound), \code{optimal}, \code{assignment} (the storage
+//'         of every game, in input order, numbered from 1) and \code{stats}
+//'         (subsets processed as nodes, copies of a size skipped as
+//'         symmetry prunings, seconds per phase).
+//' @export
+// [[Rcpp::export]]
+List dp_storage_Rcpp(SEXP j, int mem, double time_limit = 0,
+                     Nullable<Function> progress = R_NilValue) {
+  SearchStats stats(trace_requested());
+  // Tailles décroissantes ; entree[k] est la position du k-ième plus grand jeu
+  SortedInput input(j, mem);
+  const std::vector<int>& tailles = input.sizes;
+  const std::vector<int>& entree = input.input_index;
+  int n = tailles.size();
+  SearchBudget budget(time_limit);
+  connect_budget(budget, progress);
+
+  // Packing returned if the DP does not finish
+  PackingState state(mem, n);
+  pack_first_fit(tailles.data(), n, state);
+  int borne = lower_bound_l2(tailles, mem);
+  stats.lap(stats.setup_seconds);
+  if (state.num_bins() <= borne) {
+    return dp_result(state, tailles, entree, borne, true, stats);
+  }
+  if (n > MAX_DP_ITEMS) {
+    return dp_result(state, tailles, entree, borne, false, stats);
+  }
+  SearchCounters compteurs;
+
+  const uint8_t unreached = 0xFF;
+  uint32_t full = (1u << n) - 1;
+  std::vector<uint8_t> nb_memoires(full + 1, unreached);
+  std::vector<int> derniere(full + 1, 0); // remplissage de la dernière mémoire ouverte
+
+  // The empty subset starts with one open, empty storage
+  nb_memoires[0] = 1;
+  derniere[0] = 0;
+
+  long long sous_ensembles = 0;
+  for (uint32_t mask = 0; mask < full; mask++) {
+    if (!budget.tick(sous_ensembles, true, state.num_bins(), borne)) {
+      budget.rethrow();
+      compteurs.nodes = sous_ensembles;
+      stats.merge(compteurs);
+      return dp_result(state, tailles, entree, borne, false, stats);
+    }
+    if (nb_memoires[mask] == unreached) continue;
+    for (int i = 0; i < n; i++) {
+      uint32_t bit = 1u << i;
+      if (mask & bit) continue;
+      // Copies of the same size are placed in index order
+      if (i > 0 && tailles[i] == tailles[i - 1] && !(mask & (bit >> 1))) {
+        compteurs.pruned_symmetry++;
+        continue;
+      }
+
+      uint8_t memoires = nb_memoires[mask];
+      int charge = derniere[mask] + tailles[i];
+      if (charge > mem && derniere[mask] > 0) {
+        memoires++;
+        charge = tailles[i];
+      }
+      uint32_t next = mask | bit;
+      if (memoires < nb_memoires[next] ||
+          (memoires == nb_memoires[next] && charge < derniere[next])) {
+        nb_memoires[next] = memoires;
+        derniere[next] = charge;
+      }
+    }
+  }
+
+  // Walk back from the full set to recover one optimal insertion order
+  std::vector<int> ordre(n);
+  uint32_t mask = full;
+  for (int k = n - 1; k >= 0; k--) {
+    for (int i = 0; i < n; i++) {
+      uint32_t bit = 1u << i;
+      uint32_t prev = mask ^ bit;
+      if (!(mask & bit) || nb_memoires[prev] == unreached) continue;
+      uint8_t memoires = nb_memoires[prev];
+      int charge = derniere[prev] + tailles[i];
+      if (charge > mem && derniere[prev] > 0) {
+        memoires++;
+        charge = tailles[i];
+      }
+      if (memoires == nb_memoires[mask] && charge == derniere[mask]) {
+        ordre[k] = i;
+        mask = prev;
+        break;
+      }
+    }
+  }
+
+  int depart = state.num_bins();
+  state.reset(n);
+  int bin = state.open_bin();
+  for (int i : ordre) {
+    if (state.load[bin] > 0 && state.load[bin] + tailles[i] > mem) {
+      bin = state.open_bin();
+    }
+    state.place(i, bin, tailles[i]);
+  }
+
+  if (state.num_bins() < depart) {
+    compteurs.improvements++;
+    stats.improved(sous_ensembles, state.num_bins());
+  }
+  compteurs.nodes = sous_ensembles;
+  stats.merge(compteurs);
+  return dp_result(state, tailles, entree, borne, true, stats);
+}
@@ -0,0 +1,88 @@
+#include <Rcpp.h>
+using namespace Rcpp;
+using namespace std;
+
+#include <vector>
+
+#include "variableBins.h"
+#include "packingState.h"
+#include "searchBudget.h"
+#include "rInterface.h"
+
+//' Variable-size bin packing using C++
+//'
+//' Stores the games in storages chosen from a catalogue of storage types,
+//' each with its own capacity and cost, at minimal total cost. Every storage
+//' gets the cheapest type able to hold its load. First-fit and best-fit
+//' decreasing at the capacity of every type give the starting packing, which
+//' a branch and bound search then improves (games by decreasing size, tried
+//' in every storage they fit in and in a new one, nodes pruned with the cost
+//' of their storages plus the games left at the lowest cost per unit of
+//' capacity). The search can be stopped by a time or node budget, or
+//' interrupted from R, and then returns the best packing found so far.
+//' @param games a vector of games' sizes
+//' @param capacities the capacity of each storage type
+//' @param costs the cost of each storage type
+//' @param time_limit maximal running time in seconds, 0 for no limit
+//' @param max_nodes maximal number of search nodes, 0 for no limit
+//' @param progress an optional function, called about once per second with a
+//'        list (nodes, elapsed, num_bins, lower_bound) describing the search,
+//'        where lower_bound counts storages of the largest type
+//' @return a list with the storages (\code{bins}, the sizes of the games in
+//'         each one), their \code{type} (index in the catalogue, from 1),
+//'         their \code{loads}, the total \code{cost}, a \code{lower_bound} on
+//'         the cost (the cost itself once proven optimal), whether the
+//'         packing is proven \code{optimal}, the number of search nodes and
+//'         the \code{assignment} of every game to a storage, in input order
+//'         and numbered from 1, with a \code{stats} attribute (nodes, pruned
+//'         nodes, improvements, seconds per phase and, with
+//'         \code{options(StorageOptimisation.trace = TRUE)}, the trace of the
+//'         improvements, num_bins being the storages of each packing)
+//' @export
+// [[Rcpp::export]]
+List variable_bin_packing_Rcpp(SEXP games, IntegerVector capacities, NumericVector costs,
+                               double time_limit = 0, double max_nodes = 0,
+                               Nullable<Function> progress = R_NilValue) {
+  SearchStats stats(trace_requested());
+  if (capacities.size() == 0 || capacities.size() != costs.size()) {
+    stop("capacities and costs must have the same, non-zero, length");
+  }
+  std::vector<int> capacity(capacities.begin(), capacities.end());
+  std::vector<double> cost(costs.begin(), costs.end());
+  int largest = 0;
+  for (int t = 0; t < (int) capacity.size(); t++) {
+    if (capacity[t] <= 0 || capacity[t] == NA_INTEGER) stop("storage type %d has no capacity", t + 1);
+    if (!(cost[t] >= 0)) stop("storage type %d has no valid cost", t + 1);
+    largest = max(largest, capacity[t]);
+  }
+  IntegerInput input(games);
+  check_sizes(input.data(), input.size(), largest);
+  std::vector<int> items(input.data(), input.data() + input.size());
+
+  SearchBudget budget(time_limit, (long long) max_nodes);
+  connect_budget(budget, progress);
+
+  BinCatalogue catalogue(capacity, cost);
+  VariableBinSolver solver(items, catalogue);
+  solver.collect_stats(&stats);
+  stats.lap(stats.setup_seconds);
+  std::vector<int> assignment = solver.solve(budget);
+  budget.rethrow();
+  stats.lap(stats.search_seconds);
+
+  std::vector<int> sizes(items.size());
+  for (int k = 0; k < (int) sizes.size(); k++) sizes[k] = items[solver.sorted_items()[k]];
+  std::vector<int> types = solver.bin_types();
+  for (int& t : types) t++;
+
+  List result = List::create(Named("bins") = bins_list(sizes.data(), assignment.data(), sizes.size(), types.size()),
+                             Named("type") = types,
+                             Named("loads") = solver.loads(),
+                             Named("cost") = solver.cost(),
+                             Named("lower_bound") = solver.lower_bound(),
+                             Named("optimal") = solver.optimal(),
+                             Named("nodes") = (double) solver.nodes(),
+                             Named("assignment") = input_assignment(assignment, solver.sorted_items()));
+  set_stats(result, stats);
+  return result;
+}
@@ -0,0 +1,229 @@
+#ifndef VARIABLE_BINS_H
+#define VARIABLE_BINS_H
+
+#include <vector>
+#include <algorithm>
+#include <limits>
+
+#include "packingState.h"
+#include "greedyPacking.h"
+#include "lowerBounds.h"
+#include "searchBudget.h"
+#include "indexSort.h"
+#include "searchStats.h"
+#include "branching.h"
+
+// Catalogue of bin types (capacity, cost). A set of items with total load L
+// is best stored in the cheapest type holding L, so the cost of a bin is a
+// non-decreasing step function of its load, found in O(log types).
+class BinCatalogue {
+public:
+  BinCatalogue(const std::vector<int>& capacities, const std::vector<double>& costs)
+    : capacity(capacities), cost(costs), cheapest(capacities.size()), rate(0) {
+    int types = capacities.size();
+    // types by increasing capacity, then the cheapest one holding each capacity
+    by_capacity.resize(types);
+    for (int t = 0; t < types; t++) by_capacity[t] = t;
+    std::sort(by_capacity.begin(), by_capacity.end(), [&](int a, int b) {
+      return capacity[a] != capacity[b] ? capacity[a] < capacity[b] : cost[a] < cost[b];
+    });
+    for (int k = types - 1; k >= 0; k--) {
+      int t = by_capacity[k];
+      cheapest[k] = k + 1 < types && cost[by_capacity[cheapest[k + 1]]] <= cost[t] ? cheapest[k + 1] : k;
+    }
+    rate = std::numeric_limits<double>::max();
+    for (int t = 0; t < types; t++) rate = std::min(rate, cost[t] / capacity[t]);
+  }
+
+  int largest() const { return capacity[by_capacity.back()]; }
+
+  // Cheapest type whose capacity is at least `load`
+  int type_for(int load) const {
+    int k = std::lower_bound(by_capacity.begin(), by_capacity.end(), load, [&](int t, int l) {
+      return capacity[t] < l;
+    }) - by_capacity.begin();
+    return by_capacity[cheapest[k]];
+  }
+
+  double cost_for(int load) const { return cost[type_for(load)]; }
+
+  // Lowest cost per unit of capacity over all types
+  double unit_cost() const { return rate; }
+
+  int capacity_of(int type) const { return capacity[type]; }
+  int types() const { return capacity.size(); }
+
+private:
+  std::vector<int> capacity;
+  std::vector<double> cost;
+  std::vector<int> by_capacity; // types by increasing capacity
+  std::vector<int> cheapest;    // position of the cheapest type from k on
+  double rate;
+};
+
+// Variable-sized bin packing: store the items in bins drawn from the
+// catalogue at minimum total cost.
+//  - Greedy: FFD and BFD at the capacity of every type able to hold the
+//    largest item, each bin then downsized to the cheapest type holding its
+//    load; the cheapest packing is the starting incumbent.
+//  - Branch and bound over the items by decreasing size, like the single
+//    capacity solver: each item goes to every open bin it fits in (at the
+//    largest capacity) or to a new one, with the symmetry rules of
+//    branching.h. Bins are typed only at the leaves.
+//    A node costs at least sum(cost of its bins' loads) plus the remaining
+//    volume that cannot hide in the room those bins already pay for, at the
+//    lowest cost per unit of capacity.
+// The search stops when the budget is spent; the packing is then not proven
+// optimal.
+class VariableBinSolver {
+public:
+  VariableBinSolver(const std::vector<int>& items, const BinCatalogue& catalogue)
+    : catalogue(catalogue), n(items.size()), state(catalogue.largest(), items.size()),
+      explored(0), proven(false), stats(nullptr) {
+    IndexSorter sorter;
+    sorter.sort(items.data(), n, input_index);
+    for (int i : input_index) sizes.push_back(items[i]);
+    remaining.assign(n + 1, 0);
+    for (int k = n - 1; k >= 0; k--) remaining[k] = remaining[k + 1] + sizes[k];
+    root_bound = catalogue.unit_cost() * remaining[0];
+    min_bins = (remaining[0] + catalogue.largest() - 1) / catalogue.largest();
+  }
+
+  // Bin of each item, in sorted_items() order, of the cheapest packing found
+  std::vector<int> solve(SearchBudget& budget) {
+    greedy_incumbent();
+    explored = 0;
+    stopped = false;
+    counters = SearchCounters();
+    state.reset(n);
+    if (best_cost > root_bound + EPSILON) search(0, budget);
+    proven = !stopped;
+    counters.nodes = explored;
+    if (stats) stats->merge(counters);
+    return best_assignment;
+  }
+
+  // Counters (and trace, with the number of bins) of the next solve() go to
+  // `stats`
+  void collect_stats(SearchStats* target) { stats = target; }
+
+  // Position in the input of each item, by decreasing size
+  const std::vector<int>& sorted_items() const { return input_index; }
+
+  // Type of every bin of the packing returned by solve()
+  std::vector<int> bin_types() const {
+    std::vector<int> types;
+    for (int load : best_loads) types.push_back(catalogue.type_for(load));
+    return types;
+  }
+
+  const std::vector<int>& loads() const { return best_loads; }
+  double cost() const { return best_cost; }
+  double lower_bound() const { return proven ? best_cost : root_bound; }
+  bool optimal() const { return proven; }
+  long long nodes() const { return explored; }
+
+private:
+  static constexpr double EPSILON = 1e-9;
+
+  const BinCatalogue& catalogue;
+  int n;
+  std::vector<int> sizes;          // decreasing
+  std::vector<int> input_index;    // input position of each of them
+  std::vector<long long> remaining; // volume of the items from k on
+  PackingState state;
+  std::vector<int> best_assignment, best_loads;
+  double best_cost;
+  double root_bound;
+  int min_bins; // bins of the largest type the items need at least
+  long long explored;
+  bool stopped;
+  bool proven;
+  SearchCounters counters;
+  SearchStats* stats;
+
+  double packing_cost(const PackingState& packing) const {
+    double total = 0;
+    for (int load : packing.load) total += catalogue.cost_for(load);
+    return total;
+  }
+
+  // True if the packing is the cheapest so far
+  bool keep(const PackingState& packing) {
+    double total = packing_cost(packing);
+    if (!best_assignment.empty() && total >= best_cost - EPSILON) return false;
+    best_cost = total;
+    best_assignment = packing.assignment;
+    best_loads = packing.load;
+    return true;
+  }
+
+  void greedy_incumbent() {
+    best_assignment.clear();
+    PackingState packing(catalogue.largest(), n);
+    int largest_item = n > 0 ? sizes[0] : 0;
+    for (int t = 0; t < catalogue.types(); t++) {
+      int capacity = catalogue.capacity_of(t);
+      if (capacity < largest_item) continue;
+      packing.capacity = capacity;
+      pack_first_fit(sizes.data(), n, packing);
+      keep(packing);
+      pack_best_fit(sizes.data(), n, packing);
+      keep(packing);
+    }
+  }
+
+  // A bin of load L paying cost(L) ends with a load L' costing at least
+  // max(cost(L), rate * L'), so its first cost(L) / rate - L units of room
+  // come at no extra cost. That room is real-valued: rounding it down (0.7 /
+  // 0.1 is 6.999999999999999, and 2.2 / 0.575 is not a whole number at all)
+  // makes the bound exceed the optimum; the rounding errors left are far
+  // below the EPSILON the pruning allows.
+  double bound(int item) const {
+    double total = 0;
+    double hidden = 0; // remaining volume the open bins hold at no extra cost
+    for (int load : state.load) {
+      double paid = catalogue.cost_for(load);
+      total += paid;
+      double free_room = catalogue.unit_cost() > 0
+        ? paid / catalogue.unit_cost() - load
+        : state.capacity - load;
+      hidden += std::max(0.0, std::min<double>(free_room, state.capacity - load));
+    }
+    return total + catalogue.unit_cost() * std::max(0.0, remaining[item] - hidden);
+  }
+
+  void search(int item, SearchBudget& budget) {
+    if (stopped || !budget.tick(explored, true, best_loads.size(), min_bins)) {
+      stopped = true;
+      return;
+    }
+    if (item == n) {
+      if (keep(state)) {
+        counters.improvements++;
+        if (stats) stats->improved(explored, best_loads.size());
+      }
+      return;
+    }
+    if (bound(item) >= best_cost - EPSILON) {
+      counters.pruned_bound++;
+      return;
+    }
+
+    int size = sizes[item];
+    bool searched = branch_open_bins(state, sizes.data(), item, counters, [&](int bin) {
+      state.place(item, bin, size);
+      search(item + 1, budget);
+      state.remove(item, size);
+      return !stopped;
+    });
+    if (!searched) return;
+    int bin = state.open_bin();
+    state.place(item, bin, size);
+    search(item + 1, budget);
+    state.remove(item, size);
+    state.close_bin();
+  }
+};
+
+#endif
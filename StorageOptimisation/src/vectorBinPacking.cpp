@@ -0,0 +1,89 @@
+#include <Rcpp.h>
+using namespace Rcpp;
+using namespace std;
+
+#include <vector>
+#include <string>
+#include <thread>
+
+#include "vectorPacking.h"
+#include "rInterface.h"
+
+static VectorOrder parse_order(const std::string& order) {
+  if (order == "linf") return ORDER_LINF;
+  if (order == "l2") return ORDER_L2;
+  if (order == "dot") return ORDER_DOT;
+  stop("unknown order '%s', use \"linf\", \"l2\" or \"dot\"", order);
+}
+
+//' Multi-dimensional (vector) bin packing using C++
+//'
+//' First-fit decreasing when every game has several demands (size, IOPS,
+//' bandwidth, ...) and a storage takes a game only if each of them fits.
+//' Games are sorted by decreasing \code{order} of their demands divided by
+//' the capacities: the largest of them (\code{"linf"}), their euclidean norm
+//' (\code{"l2"}), or their dot product with the total demand of each
+//' dimension (\code{"dot"}), which favours the scarcest resources. First fit
+//' over all the storages costs O(games * storages) in several dimensions; on
+//' large inputs, a positive \code{shard_items} (4096 is a good size) deals
+//' the games into shards of that size, packed in parallel, for a linear
+//' running time: the packing is then no longer first-fit decreasing and takes
+//' a few percent more storages.
+//' @param demands an integer matrix with one row per game and one column per
+//'        dimension
+//' @param capacities the capacity of a storage in each dimension
+//' @param order \code{"linf"}, \code{"l2"} or \code{"dot"}
+//' @param threads number of worker threads, 0 to use every core
+//' @param shard_items the number of games per shard, or 0 (the default)
+//'        for first-fit decreasing over all the games, without shards
+//' @return a list with the storage of every game (\code{bin}, in input order,
+//'         numbered from 1), the number of storages \code{num_bins}, their
+//'         \code{loads} (one row per storage, one column per dimension) and
+//'         the \code{lower_bound} on the number of storages (total demand
+//'         over capacity, in the tightest dimension), with a \code{stats}
+//'         attribute timing its phases
+//' @export
+// [[Rcpp::export(rng = false)]]
+List vector_bin_packing_Rcpp(IntegerMatrix demands, IntegerVector capacities,
+                             std::string order = "linf", int threads = 0,
+                             int shard_items = 0) {
+  SearchStats stats;
+  VectorOrder engine = parse_order(order);
+  int n = demands.nrow();
+  int dims = demands.ncol();
+  if (dims == 0 || dims != capacities.size()) {
+    stop("demands must have one column per capacity");
+  }
+  std::vector<int> capacity(capacities.begin(), capacities.end());
+  for (int k = 0; k < dims; k++) {
+    if (capacity[k] <= 0) stop("capacity %d must be positive", k + 1);
+  }
+  // column-major, read in place
+  const int* demand = demands.begin();
+  for (int k = 0; k < dims; k++) {
+    for (int i = 0; i < n; i++) {
+      int x = demand[(long long) k * n + i];
+      if (x == NA_INTEGER) stop("demand %d of game %d is NA", k + 1, i + 1);
+      if (x < 0 || x > capacity[k]) stop("game %d does not fit in an empty storage", i + 1);
+    }
+  }
+
+  IntegerVector bin(n);
+  if (threads <= 0) threads = max(1u, thread::hardware_concurrency());
+  if (shard_items < 0) stop("shard_items must not be negative");
+  stats.lap(stats.setup_seconds);
+  int num_bins = pack_vector_ffd(demand, n, capacity, engine, threads, bin.begin(), shard_items);
+  stats.lap(stats.search_seconds);
+
+  IntegerMatrix loads(num_bins, dims);
+  for (int k = 0; k < dims; k++) {
+    for (int i = 0; i < n; i++) loads(bin[i], k) += demand[(long long) k * n + i];
+  }
+  for (int& b : bin) b++;
+  List result = List::create(Named("bin") = bin,
+                             Named("num_bins") = num_bins,
+                             Named("loads") = loads,
+                             Named("lower_bound") = vector_lower_bound(demand, n, capacity));
+  set_stats(result, stats);
+  return result;
+}
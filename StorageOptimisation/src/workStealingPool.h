@@ -0,0 +1,132 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <utility>
+#include <algorithm>
+
+// Work-stealing thread pool for tasks that may spawn more tasks.
+// Every worker owns a deque: it pushes and pops its own tasks at the back
+// (depth first, cache friendly) and, when it runs dry, steals the oldest task
+// at the front of another worker's deque, which is usually the largest
+// subproblem left. The pool returns once no task is pending, or as soon as it
+// is cancelled. Processing functions must not call the R API.
+// Deques are ring buffers which only grow: once the pool has warmed up,
+// pushing and popping tasks does not allocate.
+template <typename Task>
+class WorkStealingPool {
+public:
+  explicit WorkStealingPool(int num_threads)
+    : queues(num_threads < 1 ? 1 : num_threads) {}
+
+  int size() const { return (int) queues.size(); }
+
+  // Queues a task on the given worker (any worker before run())
+  void push(int worker, Task task) {
+    pending.fetch_add(1);
+    std::lock_guard<std::mutex> lock(queues[worker].mutex);
+    queues[worker].push_back(std::move(task));
+  }
+
+  // True while at least one worker is waiting for work, a hint to split tasks
+  bool hungry() const { return idle.load(std::memory_order_relaxed) > 0; }
+
+  void cancel() { stopped.store(true); }
+
+  bool cancelled() const { return stopped.load(std::memory_order_relaxed); }
+
+  // Runs process(task, worker) on every task, including the ones it spawns,
+  // on size() threads (the calling thread is worker 0)
+  template <typename Process>
+  void run(Process process) {
+    std::vector<std::thread> threads;
+    for (int w = 1; w < size(); w++) {
+      threads.emplace_back([this, w, &process]() { work(w, process); });
+    }
+    work(0, process);
+    for (std::thread& t : threads) t.join();
+  }
+
+private:
+  struct Queue {
+    std::mutex mutex;
+    std::vector<Task> ring; // size is a power of two
+    size_t head = 0;        // index of the front task
+    size_t count = 0;
+
+    bool empty() const { return count == 0; }
+
+    void push_back(Task task) {
+      if (count == ring.size()) {
+        std::vector<Task> larger(std::max<size_t>(16, 2 * ring.size()));
+        for (size_t k = 0; k < count; k++) larger[k] = std::move(ring[(head + k) & (ring.size() - 1)]);
+        ring.swap(larger);
+        head = 0;
+      }
+      ring[(head + count++) & (ring.size() - 1)] = std::move(task);
+    }
+
+    void pop_back(Task& task) {
+      task = std::move(ring[(head + --count) & (ring.size() - 1)]);
+    }
+
+    void pop_front(Task& task) {
+      task = std::move(ring[head]);
+      head = (head + 1) & (ring.size() - 1);
+      count--;
+    }
+  };
+
+  std::vector<Queue> queues;
+  std::atomic<long> pending{0};
+  std::atomic<int> idle{0};
+  std::atomic<bool> stopped{false};
+
+  bool pop(int worker, Task& task) {
+    Queue& q = queues[worker];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    if (q.empty()) return false;
+    q.pop_back(task);
+    return true;
+  }
+
+  bool steal(int worker, Task& task) {
+    for (int k = 1; k < size(); k++) {
+      Queue& q = queues[(worker + k) % size()];
+      std::lock_guard<std::mutex> lock(q.mutex);
+      if (q.empty()) continue;
+      q.pop_front(task);
+      return true;
+    }
+    return false;
+  }
+
+  template <typename Process>
+  void work(int worker, Process& process) {
+    bool waiting = false;
+    Task task;
+    while (!cancelled()) {
+      if (pop(worker, task) || steal(worker, task)) {
+        if (waiting) {
+          idle.fetch_sub(1);
+          waiting = false;
+        }
+        process(task, worker);
+        pending.fetch_sub(1);
+      } else {
+        if (pending.load() == 0) break;
+        if (!waiting) {
+          idle.fetch_add(1);
+          waiting = true;
+        }
+        std::this_thread::yield();
+      }
+    }
+    if (waiting) idle.fetch_sub(1);
+  }
+};
+
+#endif